@@ -0,0 +1,42 @@
+#ifndef AI_H
+#define AI_H
+
+#include "game.h" // Bitboard game core
+
+// Perfect-play opponent. Every legal 3x3 position was solved offline by
+// tools/gen_ai_table.c, so picking a move is a single table load.
+
+#define AI_POSITIONS 19683 // 3^9, one entry per base-3 encoded board
+#define AI_NO_MOVE 0x0F // Move stored for finished games
+#define AI_ILLEGAL 0xFF // Entry for boards that cannot come up in a legal game
+
+// Outcome for the side to move, stored in bits 4-5 of every legal entry
+#define AI_DRAW 0
+#define AI_WIN 1
+#define AI_LOSS 2
+
+extern const unsigned short base3[512]; // base3[mask] = sum of 3^i over the set bits of mask
+extern const unsigned char aiTable[AI_POSITIONS]; // best move | outcome << 4, or AI_ILLEGAL
+
+// Position of a board in aiTable: X counts 1, O counts 2 in each base-3 digit
+static inline int ai_index(GameBoard board) {
+	return base3[board.x] + 2 * base3[board.o];
+}
+
+// Best box (0-8) for the player whose turn it is, AI_NO_MOVE if the game is over.
+// Boards that cannot come up in legal play get the first empty box.
+static inline int ai_best_move(GameBoard board) {
+	unsigned char entry = aiTable[ai_index(board)];
+	if (entry == AI_ILLEGAL){
+		unsigned short empty = board_empty(board);
+		return empty ? __builtin_ctz(empty) : AI_NO_MOVE;
+	}
+	return entry & 0x0F;
+}
+
+// AI_WIN, AI_LOSS or AI_DRAW with perfect play from both sides
+static inline int ai_outcome(GameBoard board) {
+	return (aiTable[ai_index(board)] >> 4) & 0x03;
+}
+
+#endif
@@ -0,0 +1,161 @@
+#include <stdio.h> // Include Standard Input Output Library for reading and writing snapshots
+#include <string.h> // Include String Library for memset and strcspn
+
+#include "capture.h"
+
+typedef uint64_t __attribute__((may_alias)) CaptureWord; // Four pixels or eight characters compared at once
+
+#define PIXELS_PER_WORD 4
+#define CHARS_PER_WORD 8
+
+// Characters the text snapshot can hold, anything else is saved as '.'
+static char printable(char c) {
+	return c >= 0x20 && c <= 0x7E ? c : '.';
+}
+
+static void diff_add(CaptureDiff *diff, int x, int y) {
+	if (diff->count == 0 || x < diff->x0) diff->x0 = x;
+	if (diff->count == 0 || y < diff->y0) diff->y0 = y;
+	if (diff->count == 0 || x > diff->x1) diff->x1 = x;
+	if (diff->count == 0 || y > diff->y1) diff->y1 = y;
+	diff->count++;
+}
+
+bool capture_write_ppm(const char *path, uintptr_t pixels) {
+	unsigned char row[SCREEN_WIDTH * 3];
+	unsigned short pixel;
+	int x, y, r, g, b;
+	bool ok;
+	FILE *file = fopen(path, "wb");
+	if (!file){
+		return false;
+	}
+
+	ok = fprintf(file, "P6\n%d %d\n255\n", SCREEN_WIDTH, SCREEN_HEIGHT) > 0;
+	for (y = 0; y < SCREEN_HEIGHT && ok; y++){
+		for (x = 0; x < SCREEN_WIDTH; x++){
+			pixel = *(const unsigned short *)(pixels + (y << 10) + (x << 1));
+			r = pixel >> 11;
+			g = (pixel >> 5) & 0x3F;
+			b = pixel & 0x1F;
+			// Repeat the top bits in the bottom ones, so full brightness stays 255
+			row[x * 3] = (r << 3) | (r >> 2);
+			row[x * 3 + 1] = (g << 2) | (g >> 4);
+			row[x * 3 + 2] = (b << 3) | (b >> 2);
+		}
+		ok = fwrite(row, 1, sizeof(row), file) == sizeof(row);
+	}
+	return fclose(file) == 0 && ok;
+}
+
+bool capture_read_ppm(const char *path, unsigned short *pixels) {
+	unsigned char row[SCREEN_WIDTH * 3];
+	int width, height, maximum, x, y;
+	FILE *file = fopen(path, "rb");
+	if (!file){
+		return false;
+	}
+
+	// Header is "P6", width, height and the largest value, then one whitespace before the data
+	if (fscanf(file, "P6 %d %d %d", &width, &height, &maximum) != 3 || fgetc(file) == EOF
+		|| width != SCREEN_WIDTH || height != SCREEN_HEIGHT || maximum != 255){
+		fclose(file);
+		return false;
+	}
+	memset(pixels, 0, CAPTURE_PIXELS * sizeof(*pixels));
+	for (y = 0; y < SCREEN_HEIGHT; y++){
+		if (fread(row, 1, sizeof(row), file) != sizeof(row)){
+			fclose(file);
+			return false;
+		}
+		for (x = 0; x < SCREEN_WIDTH; x++){
+			pixels[(y << 9) + x] = ((row[x * 3] >> 3) << 11) | ((row[x * 3 + 1] >> 2) << 5) | (row[x * 3 + 2] >> 3);
+		}
+	}
+	fclose(file);
+	return true;
+}
+
+bool capture_write_text(const char *path, volatile const char *characters) {
+	char line[CHAR_COLUMNS + 1];
+	int x, y;
+	bool ok = true;
+	FILE *file = fopen(path, "w");
+	if (!file){
+		return false;
+	}
+
+	line[CHAR_COLUMNS] = '\n';
+	for (y = 0; y < CHAR_ROWS && ok; y++){
+		for (x = 0; x < CHAR_COLUMNS; x++){
+			line[x] = printable(characters[(y << 7) + x]);
+		}
+		ok = fwrite(line, 1, sizeof(line), file) == sizeof(line);
+	}
+	return fclose(file) == 0 && ok;
+}
+
+// Short lines and missing lines read as spaces
+bool capture_read_text(const char *path, char *characters) {
+	char line[CHAR_COLUMNS + 2];
+	int y;
+	size_t length;
+	FILE *file = fopen(path, "r");
+	if (!file){
+		return false;
+	}
+
+	memset(characters, ' ', CAPTURE_CHARS);
+	for (y = 0; y < CHAR_ROWS && fgets(line, sizeof(line), file); y++){
+		length = strcspn(line, "\n");
+		memcpy(characters + (y << 7), line, length);
+	}
+	fclose(file);
+	return true;
+}
+
+void capture_compare_pixels(uintptr_t a, uintptr_t b, CaptureDiff *diff) {
+	const CaptureWord *rowA, *rowB;
+	const unsigned short *pixelA, *pixelB;
+	int x, y, i;
+
+	diff->count = 0;
+	for (y = 0; y < SCREEN_HEIGHT; y++){
+		rowA = (const CaptureWord *)(a + (y << 10));
+		rowB = (const CaptureWord *)(b + (y << 10));
+		for (x = 0; x < SCREEN_WIDTH / PIXELS_PER_WORD; x++){
+			if (rowA[x] == rowB[x]){
+				continue;
+			}
+			pixelA = (const unsigned short *)&rowA[x];
+			pixelB = (const unsigned short *)&rowB[x];
+			for (i = 0; i < PIXELS_PER_WORD; i++){
+				if (pixelA[i] != pixelB[i]){
+					diff_add(diff, x * PIXELS_PER_WORD + i, y);
+				}
+			}
+		}
+	}
+}
+
+// Characters are compared as they would be saved, so a live buffer matches its own snapshot
+void capture_compare_text(volatile const char *a, volatile const char *b, CaptureDiff *diff) {
+	const CaptureWord *rowA, *rowB;
+	int x, y, i;
+
+	diff->count = 0;
+	for (y = 0; y < CHAR_ROWS; y++){
+		rowA = (const CaptureWord *)(a + (y << 7));
+		rowB = (const CaptureWord *)(b + (y << 7));
+		for (x = 0; x < CHAR_COLUMNS / CHARS_PER_WORD; x++){
+			if (rowA[x] == rowB[x]){
+				continue;
+			}
+			for (i = 0; i < CHARS_PER_WORD; i++){
+				if (printable(a[(y << 7) + x * CHARS_PER_WORD + i]) != printable(b[(y << 7) + x * CHARS_PER_WORD + i])){
+					diff_add(diff, x * CHARS_PER_WORD + i, y);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,30 @@
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <stdbool.h> // Include Standard Boolean Library for boolean variables
+#include <stdint.h> // Include fixed width integer types for buffer addresses
+
+#include "device.h" // Screen and character buffer sizes
+
+// Frame snapshots for checking rendering changes. The pixel buffer is saved as a binary
+// PPM (RGB565 widened to 8 bits a channel, which converts back exactly) and the character
+// buffer as 60 lines of 80 characters. Images read back use the same layout as the
+// device buffers (rows 1024 and 128 bytes apart), so a snapshot and a live buffer are
+// compared the same way: 8 bytes at a time, looking at single pixels only in words that differ.
+
+#define CAPTURE_PIXELS (SCREEN_HEIGHT * PIXEL_ROW_BYTES / 2) // Shorts in a pixel image
+#define CAPTURE_CHARS (CHAR_ROWS * CHAR_ROW_BYTES) // Bytes in a character image
+
+typedef struct {
+	int count; // Pixels or characters that differ, 0 if the images are the same
+	short x0, y0, x1, y1; // Bounding box of the differences, inclusive
+} CaptureDiff;
+
+bool capture_write_ppm(const char *path, uintptr_t pixels);
+bool capture_read_ppm(const char *path, unsigned short *pixels); // Fills CAPTURE_PIXELS shorts
+bool capture_write_text(const char *path, volatile const char *characters);
+bool capture_read_text(const char *path, char *characters); // Fills CAPTURE_CHARS bytes
+void capture_compare_pixels(uintptr_t a, uintptr_t b, CaptureDiff *diff);
+void capture_compare_text(volatile const char *a, volatile const char *b, CaptureDiff *diff);
+
+#endif
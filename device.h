@@ -0,0 +1,52 @@
+#ifndef DEVICE_H
+#define DEVICE_H
+
+#include <stdbool.h> // Include Standard Boolean Library for boolean variables
+#include <stdint.h> // Include fixed width integer types for buffer addresses
+
+// Hardware abstraction used by the game. Two backends implement it:
+//   device_de10.c - the DE10-Standard board (memory mapped I/O, GIC interrupts)
+//   device_host.c - an in-memory simulation so the game runs on a normal Linux box
+// Exactly one of them is linked together with tictactoe.c.
+
+// VGA pixel buffer: 320x240 RGB565, every row is 1024 bytes apart (y << 10)
+#define SCREEN_WIDTH 320
+#define SCREEN_HEIGHT 240
+#define PIXEL_ROW_BYTES 1024
+
+// Pixel buffer controller registers: writing 1 to the front buffer register asks for a
+// swap at the next vertical sync, bit 0 of the status register stays set until it happened
+#define PIXEL_STATUS_SWAPPING 0x01
+
+// VGA character buffer: 80x60 characters, every row is 128 bytes apart (y << 7)
+#define CHAR_COLUMNS 80
+#define CHAR_ROWS 60
+#define CHAR_ROW_BYTES 128
+
+// PS/2 data register: bit 15 (RVALID) is set when the low byte holds data
+#define PS2_RVALID 0x8000
+
+// Frame ticks per second, the main loop updates and redraws once per tick
+#define FRAME_RATE 60
+
+// Functions every backend provides
+void device_init(void); // Brings the video and PS/2 devices into a known state
+void device_configure_interrupts(void); // Routes PS/2 interrupts to keygameBoard_ISR, starts the frame tick and enables both
+uintptr_t device_pixel_buffer(void); // Address of the pixel buffer currently being displayed
+uintptr_t device_back_buffer(void); // Address of the pixel buffer being drawn, shown after the next swap
+void device_swap_buffers(void); // Swaps front and back buffer at the next vertical sync and waits for it
+unsigned int device_ticks(void); // Free-running counter for measuring time, wraps around
+unsigned int device_ticks_per_us(void); // device_ticks per microsecond
+unsigned int device_cycles(void); // CPU cycle counter for profiling, wraps around
+unsigned int device_cycles_per_us(void); // device_cycles per microsecond
+volatile char * device_char_buffer(void); // Address of the character buffer
+int device_ps2_read(void); // Reads the PS/2 data register (one byte from the FIFO)
+void device_ps2_ack(void); // Clears the pending PS/2 interrupt
+unsigned int device_frame_ticks(void); // Frame ticks since device_configure_interrupts
+bool device_idle(void); // Sleeps until an interrupt has been handled, returns false once there is no more input to wait for
+int device_exit(int xScore, int OScore, int totalMatchesPlayed); // Saves or checks recorded input, returns the exit status
+
+// Provided by the game, called by the backend for every PS/2 interrupt
+void keygameBoard_ISR(void);
+
+#endif
@@ -0,0 +1,255 @@
+
+#include "device.h"
+#include "profile.h" // IRQ timing
+
+#define TIMER_CLOCK 100000000 // FPGA interval timer counts at 100 MHz
+#define CPU_CLOCK_MHZ 800 // A9 core clock, four times the private timer
+
+static volatile unsigned int frameTicks = 0; // Counted by the interval timer interrupt
+static volatile unsigned int interruptCount = 0; // Every IRQ handled so far
+static unsigned int interruptsSeen = 0; // interruptCount when device_idle last returned
+
+// Function prototypes for configuring and handling interrupts
+void disableInterrupts(void);// Disables interrupts in the ARM A9 processor
+void setIRQStack(void);// Sets up the stack for IRQ mode
+void configureGIC(void);// Configures the General Interrupt Controller (GIC)
+void configureKEYs(void);// Configures the FPGA's PS/2 port for keygameBoard interrupts
+void configureFrameTimer(void);// Starts the FPGA interval timer interrupting FRAME_RATE times a second
+void enable_A9_interrupts(void);// Enables interrupts in the ARM A9 processor
+void configureinterrupt(int, int);// Configures individual interrupts
+
+void device_init(void) {
+	volatile int * pixel_ctrl_ptr = (int *)0xFF203020;
+	volatile int * timer_ptr = (int *)0xFFFEC600; // A9 private timer
+
+	// Front buffer stays in on-chip memory, the back buffer goes into SDRAM
+	*(pixel_ctrl_ptr + 1) = 0xC0000000;
+
+	// Let the private timer count down from the top forever at the full 200 MHz
+	*(timer_ptr) = 0xFFFFFFFF; // load value
+	*(timer_ptr + 2) = 0b011; // enable, auto-reload, prescaler 0
+
+	// PMU cycle counter: PMCR enable and reset, then switch the cycle counter on in PMCNTENSET
+	asm volatile("mcr p15, 0, %0, c9, c12, 0" : : "r"(0b101));
+	asm volatile("mcr p15, 0, %0, c9, c12, 1" : : "r"(0x80000000));
+}
+
+void device_configure_interrupts(void) {
+	disableInterrupts(); // disable interrupts in the A9 processor
+	setIRQStack(); // initialize the stack pointer for IRQ mode
+	configureGIC(); // configure the general interrupt controller
+	configureKEYs(); // configure pushbutton KEYs to generate interrupts
+	configureFrameTimer(); // frame tick
+	enable_A9_interrupts(); // enable interrupts in the A9 processor
+}
+
+uintptr_t device_pixel_buffer(void) {
+	volatile int * pixel_ctrl_ptr = (int *)0xFF203020;
+
+	/* Read location of the pixel buffer from the pixel buffer controller */
+	return (uintptr_t)*pixel_ctrl_ptr;
+}
+
+uintptr_t device_back_buffer(void) {
+	volatile int * pixel_ctrl_ptr = (int *)0xFF203020;
+	return (uintptr_t)*(pixel_ctrl_ptr + 1);
+}
+
+void device_swap_buffers(void) {
+	volatile int * pixel_ctrl_ptr = (int *)0xFF203020;
+	*pixel_ctrl_ptr = 1; // request the swap
+	while (*(pixel_ctrl_ptr + 3) & PIXEL_STATUS_SWAPPING); // wait for vertical sync
+}
+
+// The private timer counts down, flip it so time goes up
+unsigned int device_ticks(void) {
+	volatile int * timer_ptr = (int *)0xFFFEC600;
+	return ~(unsigned int)*(timer_ptr + 1);
+}
+
+unsigned int device_ticks_per_us(void) {
+	return 200;
+}
+
+// PMCCNTR, counts every core clock
+unsigned int device_cycles(void) {
+	unsigned int cycles;
+	asm volatile("mrc p15, 0, %0, c9, c13, 0" : "=r"(cycles));
+	return cycles;
+}
+
+unsigned int device_cycles_per_us(void) {
+	return CPU_CLOCK_MHZ;
+}
+
+volatile char * device_char_buffer(void) {
+	return (volatile char *)0xC9000000; // video character buffer
+}
+
+int device_ps2_read(void) {
+	volatile int * PS2_ptr = (int *)0xFF200100; // Points to PS2 Base
+	return *(PS2_ptr);
+}
+
+void device_ps2_ack(void) {
+	volatile int * PS2_ptr = (int *)0xFF200100; // Points to PS2 Base
+
+	//Read Interrupt Register
+	int readInterruptReg;
+	readInterruptReg = *(PS2_ptr + 1 );
+
+	//Clear Interrupt
+	*(PS2_ptr+1) = readInterruptReg;
+}
+
+unsigned int device_frame_ticks(void) {
+	return frameTicks;
+}
+
+// Interrupts are masked while checking, so one that comes in between still wakes the
+// wfi (it only needs the interrupt pending, not taken) and is handled once they are back on
+bool device_idle(void) {
+	disableInterrupts();
+	if (interruptCount == interruptsSeen){
+		asm volatile("wfi");
+	}
+	enable_A9_interrupts();
+	interruptsSeen = interruptCount;
+	return true;
+}
+
+// The board never runs out of input, nothing calls this
+int device_exit(int xScore, int OScore, int totalMatchesPlayed) {
+	return 0;
+}
+
+/* setup the PS/2 interrupts in the FPGA */
+void configureKEYs() {
+	volatile int * PS2_ptr = (int *) 0xFF200100; // PS/2 base address
+	*(PS2_ptr + 1) = 0x00000001; // set RE to 1 to enable interrupts
+}
+
+/* setup the interval timer to interrupt FRAME_RATE times a second */
+void configureFrameTimer() {
+	volatile int * timer_ptr = (int *) 0xFF202000; // interval timer base address
+	*(timer_ptr + 2) = (TIMER_CLOCK / FRAME_RATE) & 0xFFFF; // period, low half
+	*(timer_ptr + 3) = (TIMER_CLOCK / FRAME_RATE) >> 16; // period, high half
+	*(timer_ptr + 1) = 0b0111; // START, CONT and ITO
+}
+
+// Define the IRQ exception handler
+void __attribute__((interrupt)) __cs3_isr_irq(void) {
+	unsigned int start = profile_begin();
+	// Read the ICCIAR from the CPU Interface in the GIC
+	int interrupt_ID = *((int *)0xFFFEC10C);
+	if (interrupt_ID == 79) // check if interrupt is from the KEYs
+	keygameBoard_ISR();
+	else if (interrupt_ID == 72){ // frame tick from the interval timer
+		*((int *)0xFF202000) = 0; // clear TO
+		frameTicks++;
+	}
+	else
+	while (1); // if unexpected, then stay here
+	interruptCount++;
+	profile_end(PROFILE_IRQ, start);
+	// Write to the End of Interrupt Register (ICCEOIR)
+	*((int *)0xFFFEC110) = interrupt_ID;
+}
+
+// Define the remaining exception handlers
+void __attribute__((interrupt)) __cs3_reset(void) {
+	while (1);
+}
+
+void __attribute__((interrupt)) __cs3_isr_undef(void) {
+	while (1);
+}
+
+void __attribute__((interrupt)) __cs3_isr_swi(void) {
+	while (1);
+}
+
+void __attribute__((interrupt)) __cs3_isr_pabort(void) {
+	while (1);
+}
+
+void __attribute__((interrupt)) __cs3_isr_dabort(void) {
+	while (1);
+}
+
+void __attribute__((interrupt)) __cs3_isr_fiq(void) {
+	while (1);
+}
+
+//Initialize the banked stack pointer register for IRQ mode
+void setIRQStack(void) {
+	int stack, mode;
+	stack = 0xFFFFFFFF - 7; // top of A9 onchip memory, aligned to 8 bytes
+	/* change processor to IRQ mode with interrupts disabled */
+	mode = 0b11010010;
+	asm("msr cpsr, %[ps]" : : [ps] "r"(mode));
+	/* set banked stack pointer */
+	asm("mov sp, %[ps]" : : [ps] "r"(stack));
+	/* go back to SVC mode before executing subroutine return! */
+	mode = 0b11010011;
+	asm("msr cpsr, %[ps]" : : [ps] "r"(mode));
+}
+
+/*
+* Turn on interrupts in the ARM processor
+*/
+void enable_A9_interrupts(void) {
+	int status = 0b01010011;
+	asm("msr cpsr, %[ps]" : : [ps] "r"(status));
+}
+
+// Turn off interrupts in the ARM processor
+void disableInterrupts(void) {
+	int status = 0b11010011;
+	asm("msr cpsr, %[ps]" : : [ps] "r"(status));
+}
+
+/*
+* Configure the Generic Interrupt Controller (GIC)
+*/
+void configureGIC(void) {
+	configureinterrupt (79, 1); // configure the FPGA KEYs interrupt (73)
+	configureinterrupt (72, 1); // configure the interval timer interrupt
+	// Set Interrupt Priority Mask Register (ICCPMR). Enable interrupts of all
+	// priorities
+	*((int *) 0xFFFEC104) = 0xFFFF;
+	// Set CPU Interface Control Register (ICCICR). Enable signaling of
+	// interrupts
+	*((int *) 0xFFFEC100) = 1;
+	// Configure the Distributor Control Register (ICDDCR) to send pending
+	// interrupts to CPUs
+	*((int *) 0xFFFED000) = 1;
+}
+
+/*
+* Configure Set Enable Registers (ICDISERn) and Interrupt Processor Target
+* Registers (ICDIPTRn). The default (reset) values are used for other registers
+* in the GIC.
+*/
+void configureinterrupt(int N, int CPU_target) {
+	int reg_offset, index, value, address;
+	/* Configure the Interrupt Set-Enable Registers (ICDISERn).
+	* reg_offset = (integer_div(N / 32) * 4
+	* value = 1 << (N mod 32) */
+	reg_offset = (N >> 3) & 0xFFFFFFFC;
+	index = N & 0x1F;
+	value = 0x1 << index;
+	address = 0xFFFED100 + reg_offset;
+	/* Now that we know the register address and value, set the appropriate bit */
+	*(int *)address |= value;
+
+	/* Configure the Interrupt Processor Targets Register (ICDIPTRn)
+	* reg_offset = integer_div(N / 4) * 4
+	* index = N mod 4 */
+	reg_offset = (N & 0xFFFFFFFC);
+	index = N & 0x3;
+	address = 0xFFFED800 + reg_offset + index;
+	/* Now that we know the register address and value, write to (only) the
+	* appropriate byte */
+	*(char *)address = (char)CPU_target;
+}
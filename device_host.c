@@ -0,0 +1,330 @@
+
+#include <stdio.h> // Include Standard Input Output Library for reading scancodes
+#include <stdlib.h> // Include Standard Library for getenv and exit
+#include <string.h> // Include String Library for memset
+#include <time.h> // Include Time Library for clock_gettime
+
+#include "device.h"
+#include "profile.h" // IRQ timing
+#include "trace.h" // Recorded input
+#include "capture.h" // Frame snapshots
+
+// In-memory stand-ins for the DE10 video and PS/2 devices.
+// Scancodes are read from stdin as hex bytes ("22 5A 1B 5A"), '#' starts a comment.
+// Time between frames is simulated: every device_idle is one frame tick, and the keyboard
+// delivers at most what a real one can send in that time, so runs are repeatable.
+//
+// Environment variables:
+//   TICTACTOE_RECORD=file   save every byte the ISR saw, and the final state, as a trace
+//   TICTACTOE_REPLAY=file   read input from a trace instead of stdin and check the final state
+//   TICTACTOE_REALTIME=1    replay with the recorded timing instead of as fast as possible
+//   TICTACTOE_CAPTURE=name  save the last frame as name.ppm and name.txt
+//   TICTACTOE_CAPTURE_FRAMES=1  also save every frame shown as name-00001.ppm, name-00001.txt, ...
+//   TICTACTOE_GOLDEN=name   compare the last frame with name.ppm and name.txt
+
+#define PS2_FIFO_SIZE 256 // same depth as the FIFO in the DE10 PS/2 port
+#define PS2_BYTES_PER_FRAME 16 // 11 bits a byte at 10-16.7 kHz is roughly 1000 bytes a second
+
+static short int pixelBuffers[2][SCREEN_HEIGHT * (PIXEL_ROW_BYTES / 2)]; // 320x240 RGB565 plus row padding
+static int frontBuffer = 0; // pixelBuffers index on screen, the other one is the back buffer
+static unsigned int swapCount = 0;
+static char characterBuffer[CHAR_ROWS * CHAR_ROW_BYTES]; // 80x60 characters plus row padding
+
+static unsigned char ps2Fifo[PS2_FIFO_SIZE];
+static int ps2Head = 0; // next byte to read
+static int ps2Count = 0; // bytes waiting in the FIFO
+static bool ps2InterruptPending = false;
+static bool interruptsEnabled = false;
+static unsigned int frameTicks = 0;
+
+static bool replaying = false;
+static bool replayRealtime = false;
+static TraceReader replay;
+static TraceSummary replaySummary; // Final state when the trace was recorded
+static bool replayPending = false; // replayByte is read from the trace but not delivered yet
+static unsigned char replayByte;
+static unsigned int replayByteTime;
+static unsigned long long replayClock = 0; // Simulated microseconds at the current frame
+static struct timespec replayStart; // Wall clock when interrupts were configured
+
+// Adds a byte to the simulated PS/2 FIFO, dropping it like the hardware does when full
+bool host_ps2_push(unsigned char byte) {
+	if (ps2Count == PS2_FIFO_SIZE){
+		return false;
+	}
+	ps2Fifo[(ps2Head + ps2Count) % PS2_FIFO_SIZE] = byte;
+	ps2Count++;
+	ps2InterruptPending = true;
+	return true;
+}
+
+// Reads up to count hex scancodes from stdin into the FIFO, returns false at end of input
+static bool refill_from_stdin(int count) {
+	unsigned int byte;
+	int c;
+	while (count > 0 && ps2Count < PS2_FIFO_SIZE){
+		if (scanf(" %x", &byte) == 1){
+			host_ps2_push((unsigned char)byte);
+			count--;
+			continue;
+		}
+		c = getchar();
+		if (c == EOF){
+			return ps2Count > 0;
+		}
+		// Skip comments and anything else that is not a hex byte
+		if (c == '#'){
+			while (c != '\n' && c != EOF){
+				c = getchar();
+			}
+		}
+	}
+	return true;
+}
+
+// Delivers the bytes that are due by the current frame, at most count of them. Played as
+// fast as possible, frames without input are skipped. Returns false at the end of the trace.
+static bool refill_from_trace(int count) {
+	struct timespec due;
+	if (!replayPending){
+		replayPending = trace_next(&replay, &replayByte, &replayByteTime);
+	}
+	if (!replayPending){
+		return false;
+	}
+	
+	if (replayRealtime){
+		due.tv_sec = replayStart.tv_sec + replayClock / 1000000;
+		due.tv_nsec = replayStart.tv_nsec + replayClock % 1000000 * 1000;
+		if (due.tv_nsec >= 1000000000){
+			due.tv_sec++;
+			due.tv_nsec -= 1000000000;
+		}
+		clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &due, NULL);
+	} else if (replayByteTime > replayClock){
+		replayClock = replayByteTime;
+	}
+	
+	while (replayPending && count > 0 && replayByteTime <= replayClock){
+		host_ps2_push(replayByte);
+		count--;
+		replayPending = trace_next(&replay, &replayByte, &replayByteTime);
+	}
+	replayClock += 1000000 / FRAME_RATE;
+	return true;
+}
+
+void device_init(void) {
+	const char *path = getenv("TICTACTOE_REPLAY");
+	memset(pixelBuffers, 0, sizeof(pixelBuffers));
+	frontBuffer = 0;
+	swapCount = 0;
+	memset(characterBuffer, 0, sizeof(characterBuffer));
+	ps2Head = 0;
+	ps2Count = 0;
+	ps2InterruptPending = false;
+	
+	if (path){
+		if (!trace_load(path, &replay, &replaySummary)){
+			fprintf(stderr, "cannot read trace %s\n", path);
+			exit(1);
+		}
+		replaying = true;
+		replayRealtime = getenv("TICTACTOE_REALTIME") != NULL;
+	}
+}
+
+void device_configure_interrupts(void) {
+	interruptsEnabled = true;
+	frameTicks = 0;
+	clock_gettime(CLOCK_MONOTONIC, &replayStart);
+}
+
+uintptr_t device_pixel_buffer(void) {
+	return (uintptr_t)pixelBuffers[frontBuffer];
+}
+
+uintptr_t device_back_buffer(void) {
+	return (uintptr_t)pixelBuffers[!frontBuffer];
+}
+
+// Writes name.ppm and name.txt from what is on screen
+static bool capture(const char *name) {
+	char path[FILENAME_MAX];
+	snprintf(path, sizeof(path), "%s.ppm", name);
+	if (!capture_write_ppm(path, device_pixel_buffer())){
+		return false;
+	}
+	snprintf(path, sizeof(path), "%s.txt", name);
+	return capture_write_text(path, characterBuffer);
+}
+
+// There is no beam to wait for, vertical sync happens right away
+void device_swap_buffers(void) {
+	const char *name = getenv("TICTACTOE_CAPTURE");
+	char frameName[FILENAME_MAX];
+	frontBuffer = !frontBuffer;
+	swapCount++;
+	
+	if (name && getenv("TICTACTOE_CAPTURE_FRAMES")){
+		snprintf(frameName, sizeof(frameName), "%s-%05u", name, swapCount);
+		if (!capture(frameName)){
+			fprintf(stderr, "cannot write %s\n", frameName);
+		}
+	}
+}
+
+// Number of buffer swaps since device_init
+unsigned int host_swap_count(void) {
+	return swapCount;
+}
+
+unsigned int device_ticks(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (unsigned int)(ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+}
+
+unsigned int device_ticks_per_us(void) {
+	return 1000;
+}
+
+// There is no portable cycle counter, so nanoseconds stand in for cycles
+unsigned int device_cycles(void) {
+	return device_ticks();
+}
+
+unsigned int device_cycles_per_us(void) {
+	return 1000;
+}
+
+volatile char * device_char_buffer(void) {
+	return characterBuffer;
+}
+
+// Same layout as the DE10 data register: RAVAIL in bits 31..16, RVALID in bit 15
+int device_ps2_read(void) {
+	int data;
+	if (ps2Count == 0){
+		return 0;
+	}
+	data = ps2Fifo[ps2Head] | PS2_RVALID;
+	ps2Head = (ps2Head + 1) % PS2_FIFO_SIZE;
+	ps2Count--;
+	return data | (ps2Count << 16);
+}
+
+void device_ps2_ack(void) {
+	ps2InterruptPending = ps2Count > 0;
+}
+
+unsigned int device_frame_ticks(void) {
+	return frameTicks;
+}
+
+// One frame goes by: the next bytes of input arrive, the PS/2 interrupt is raised until
+// the ISR has emptied the FIFO, then the frame tick. Blocks while stdin has nothing yet.
+bool device_idle(void) {
+	bool more = replaying ? refill_from_trace(PS2_BYTES_PER_FRAME) : refill_from_stdin(PS2_BYTES_PER_FRAME);
+	while (interruptsEnabled && ps2InterruptPending){
+		unsigned int start = profile_begin();
+		keygameBoard_ISR();
+		profile_end(PROFILE_IRQ, start);
+	}
+	frameTicks++;
+	return more;
+}
+
+// Reports one field of the final state, returns whether it matched the recording
+static bool check(const char *name, const char *format, unsigned long long replayed, unsigned long long recorded) {
+	if (replayed != recorded){
+		printf("replay mismatch: %s is ", name);
+		printf(format, replayed);
+		printf(", recorded ");
+		printf(format, recorded);
+		printf("\n");
+		return false;
+	}
+	return true;
+}
+
+// Compares the screen with name.ppm and name.txt, returns whether both match
+static bool compare_golden(const char *name) {
+	static unsigned short goldenPixels[CAPTURE_PIXELS];
+	static char goldenChars[CAPTURE_CHARS];
+	char path[FILENAME_MAX];
+	CaptureDiff diff;
+	bool same = true;
+	
+	snprintf(path, sizeof(path), "%s.ppm", name);
+	if (!capture_read_ppm(path, goldenPixels)){
+		printf("golden: cannot read %s\n", path);
+		return false;
+	}
+	capture_compare_pixels(device_pixel_buffer(), (uintptr_t)goldenPixels, &diff);
+	if (diff.count){
+		printf("golden: %d pixels differ from %s, inside (%d,%d)-(%d,%d)\n", diff.count, path, diff.x0, diff.y0, diff.x1, diff.y1);
+		same = false;
+	}
+	
+	snprintf(path, sizeof(path), "%s.txt", name);
+	if (!capture_read_text(path, goldenChars)){
+		printf("golden: cannot read %s\n", path);
+		return false;
+	}
+	capture_compare_text(characterBuffer, goldenChars, &diff);
+	if (diff.count){
+		printf("golden: %d characters differ from %s, inside columns %d-%d, rows %d-%d\n", diff.count, path, diff.x0, diff.x1, diff.y0, diff.y1);
+		same = false;
+	}
+	
+	printf("golden: %s\n", same ? "frame matches" : "frame does not match");
+	return same;
+}
+
+int device_exit(int xScore, int OScore, int totalMatchesPlayed) {
+	const char *path = getenv("TICTACTOE_RECORD");
+	const char *captureName = getenv("TICTACTOE_CAPTURE");
+	const char *goldenName = getenv("TICTACTOE_GOLDEN");
+	TraceSummary summary;
+	struct timespec now;
+	bool same = true, matches = true, recorded = true; // Golden frame, replayed state, whole session in the trace
+	
+	trace_summarize(&summary, xScore, OScore, totalMatchesPlayed);
+	if (path && !trace_save(path, &summary)){
+		fprintf(stderr, "cannot write trace %s\n", path);
+		return 1;
+	}
+	if (path && trace_dropped() > 0){
+		fprintf(stderr, "trace buffer full: %u bytes after the first %u were not recorded, %s will replay without the state check\n",
+			trace_dropped(), trace_count(), path);
+		recorded = false;
+	}
+	if (captureName && !capture(captureName)){
+		fprintf(stderr, "cannot write %s\n", captureName);
+		return 1;
+	}
+	if (goldenName){
+		same = compare_golden(goldenName);
+	}
+	if (!replaying){
+		return same && recorded ? 0 : 1;
+	}
+	
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	printf("replayed %u bytes in %lld ms\n", replay.index,
+		(now.tv_sec - replayStart.tv_sec) * 1000LL + (now.tv_nsec - replayStart.tv_nsec) / 1000000);
+	trace_close(&replay);
+	if (replay.dropped > 0){
+		printf("replay not checked: the recording lost %u bytes once its buffer was full\n", replay.dropped);
+		return same && recorded ? 0 : 1;
+	}
+	
+	matches &= check("framebuffer hash", "%016llx", summary.pixelHash, replaySummary.pixelHash);
+	matches &= check("character buffer hash", "%016llx", summary.charHash, replaySummary.charHash);
+	matches &= check("xScore", "%llu", summary.xScore, replaySummary.xScore);
+	matches &= check("OScore", "%llu", summary.OScore, replaySummary.OScore);
+	matches &= check("totalMatchesPlayed", "%llu", summary.totalMatchesPlayed, replaySummary.totalMatchesPlayed);
+	printf("replay %s\n", matches ? "matches the recording" : "does not match the recording");
+	return same && matches && recorded ? 0 : 1;
+}
@@ -0,0 +1,97 @@
+#include "device.h" // Screen size
+#include "dirty.h"
+
+static DirtyRect rects[DIRTY_MAX_RECTS];
+static int rectCount = 0;
+
+static inline int rect_area(const DirtyRect *rect) {
+	return (rect->x1 - rect->x0 + 1) * (rect->y1 - rect->y0 + 1);
+}
+
+// True if inner lies completely inside outer
+static inline bool rect_contains(const DirtyRect *outer, const DirtyRect *inner) {
+	return outer->x0 <= inner->x0 && outer->y0 <= inner->y0 &&
+		outer->x1 >= inner->x1 && outer->y1 >= inner->y1;
+}
+
+// Grows into so it also covers from
+static inline void rect_merge(DirtyRect *into, const DirtyRect *from) {
+	if (from->x0 < into->x0) into->x0 = from->x0;
+	if (from->y0 < into->y0) into->y0 = from->y0;
+	if (from->x1 > into->x1) into->x1 = from->x1;
+	if (from->y1 > into->y1) into->y1 = from->y1;
+}
+
+// Removes every rectangle except keep that lies inside rects[keep], returns keep's new slot
+static int drop_covered(int keep) {
+	int i = 0;
+	while (i < rectCount){
+		if (i != keep && rect_contains(&rects[keep], &rects[i])){
+			rectCount--;
+			rects[i] = rects[rectCount];
+			if (keep == rectCount){
+				keep = i;
+			}
+		} else {
+			i++;
+		}
+	}
+	return keep;
+}
+
+void dirty_add(int x0, int y0, int x1, int y1) {
+	DirtyRect rect, grown;
+	int i, best = 0, growth, bestGrowth;
+
+	if (x0 < 0) x0 = 0;
+	if (y0 < 0) y0 = 0;
+	if (x1 >= SCREEN_WIDTH) x1 = SCREEN_WIDTH - 1;
+	if (y1 >= SCREEN_HEIGHT) y1 = SCREEN_HEIGHT - 1;
+	if (x0 > x1 || y0 > y1){
+		return;
+	}
+	rect.x0 = x0;
+	rect.y0 = y0;
+	rect.x1 = x1;
+	rect.y1 = y1;
+
+	// Nothing to do if it is already marked
+	for (i = 0; i < rectCount; i++){
+		if (rect_contains(&rects[i], &rect)){
+			return;
+		}
+	}
+
+	if (rectCount < DIRTY_MAX_RECTS){
+		rects[rectCount] = rect;
+		rectCount++;
+		drop_covered(rectCount - 1);
+		return;
+	}
+
+	// Out of slots: join the rectangle whose area grows least
+	bestGrowth = SCREEN_WIDTH * SCREEN_HEIGHT + 1;
+	for (i = 0; i < rectCount; i++){
+		grown = rects[i];
+		rect_merge(&grown, &rect);
+		growth = rect_area(&grown) - rect_area(&rects[i]);
+		if (growth < bestGrowth){
+			bestGrowth = growth;
+			best = i;
+		}
+	}
+	rect_merge(&rects[best], &rect);
+	drop_covered(best);
+}
+
+int dirty_count(void) {
+	return rectCount;
+}
+
+const DirtyRect * dirty_rects(void) {
+	return rects;
+}
+
+void dirty_reset(void) {
+	rectCount = 0;
+}
@@ -0,0 +1,20 @@
+#ifndef DIRTY_H
+#define DIRTY_H
+
+// Dirty rectangle tracker. Everything that changes the picture marks the screen area it
+// touches, and only those areas are redrawn and copied between the two pixel buffers.
+// Rectangles are inclusive on both ends and clamped to the 320x240 screen.
+
+#define DIRTY_MAX_RECTS 16 // Past this, a new rectangle merges into the one it grows least
+
+typedef struct {
+	short x0, y0; // Top left corner
+	short x1, y1; // Bottom right corner
+} DirtyRect;
+
+void dirty_add(int x0, int y0, int x1, int y1); // Marks a rectangle as changed
+int dirty_count(void); // Rectangles marked since the last dirty_reset
+const DirtyRect * dirty_rects(void); // The marked rectangles, none of them inside another
+void dirty_reset(void); // Forgets every rectangle once the frame is shown
+
+#endif
@@ -0,0 +1,30 @@
+
+#include "game.h"
+
+// Winning lines in the same order check_winner has always tested them
+const unsigned short winMasks[8] = {
+	0x049, 0x092, 0x124, // First, second and third column
+	0x007, 0x038, 0x1C0, // First, second and third row
+	0x111, 0x054 // Left and right diagonal
+};
+
+// For every 9-bit mask, 1 + the index of the first line in winMasks it completes (0 = no line).
+// Replaces the 16 triple comparisons with one load per player.
+const unsigned char winLine[512] = {
+	0, 0, 0, 0, 0, 0, 0, 4, 0, 0, 0, 0, 0, 0, 0, 4, 0, 0, 0, 0, 0, 0, 0, 4, 0, 0, 0, 0, 0, 0, 0, 4,
+	0, 0, 0, 0, 0, 0, 0, 4, 0, 0, 0, 0, 0, 0, 0, 4, 0, 0, 0, 0, 0, 0, 0, 4, 5, 5, 5, 5, 5, 5, 5, 4,
+	0, 0, 0, 0, 0, 0, 0, 4, 0, 1, 0, 1, 0, 1, 0, 1, 0, 0, 0, 0, 8, 8, 8, 4, 0, 1, 0, 1, 8, 1, 8, 1,
+	0, 0, 0, 0, 0, 0, 0, 4, 0, 1, 0, 1, 0, 1, 0, 1, 0, 0, 0, 0, 8, 8, 8, 4, 5, 1, 5, 1, 5, 1, 5, 1,
+	0, 0, 0, 0, 0, 0, 0, 4, 0, 0, 0, 0, 0, 0, 0, 4, 0, 0, 2, 2, 0, 0, 2, 2, 0, 0, 2, 2, 0, 0, 2, 2,
+	0, 0, 0, 0, 0, 0, 0, 4, 0, 0, 0, 0, 0, 0, 0, 4, 0, 0, 2, 2, 0, 0, 2, 2, 5, 5, 2, 2, 5, 5, 2, 2,
+	0, 0, 0, 0, 0, 0, 0, 4, 0, 1, 0, 1, 0, 1, 0, 1, 0, 0, 2, 2, 8, 8, 2, 2, 0, 1, 2, 1, 8, 1, 2, 1,
+	0, 0, 0, 0, 0, 0, 0, 4, 0, 1, 0, 1, 0, 1, 0, 1, 0, 0, 2, 2, 8, 8, 2, 2, 5, 1, 2, 1, 5, 1, 2, 1,
+	0, 0, 0, 0, 0, 0, 0, 4, 0, 0, 0, 0, 0, 0, 0, 4, 0, 7, 0, 7, 0, 7, 0, 4, 0, 7, 0, 7, 0, 7, 0, 4,
+	0, 0, 0, 0, 3, 3, 3, 3, 0, 0, 0, 0, 3, 3, 3, 3, 0, 7, 0, 7, 3, 3, 3, 3, 5, 5, 5, 5, 3, 3, 3, 3,
+	0, 0, 0, 0, 0, 0, 0, 4, 0, 1, 0, 1, 0, 1, 0, 1, 0, 7, 0, 7, 8, 7, 8, 4, 0, 1, 0, 1, 8, 1, 8, 1,
+	0, 0, 0, 0, 3, 3, 3, 3, 0, 1, 0, 1, 3, 1, 3, 1, 0, 7, 0, 7, 3, 3, 3, 3, 5, 1, 5, 1, 3, 1, 3, 1,
+	0, 0, 0, 0, 0, 0, 0, 4, 0, 0, 0, 0, 0, 0, 0, 4, 0, 7, 2, 2, 0, 7, 2, 2, 0, 7, 2, 2, 0, 7, 2, 2,
+	0, 0, 0, 0, 3, 3, 3, 3, 0, 0, 0, 0, 3, 3, 3, 3, 0, 7, 2, 2, 3, 3, 2, 2, 5, 5, 2, 2, 3, 3, 2, 2,
+	6, 6, 6, 6, 6, 6, 6, 4, 6, 1, 6, 1, 6, 1, 6, 1, 6, 6, 2, 2, 6, 6, 2, 2, 6, 1, 2, 1, 6, 1, 2, 1,
+	6, 6, 6, 6, 3, 3, 3, 3, 6, 1, 6, 1, 3, 1, 3, 1, 6, 6, 2, 2, 3, 3, 2, 2, 5, 1, 2, 1, 3, 1, 2, 1,
+};
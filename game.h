@@ -0,0 +1,98 @@
+#ifndef GAME_H
+#define GAME_H
+
+#include <stdbool.h> // Include Standard Boolean Library for boolean variables
+
+// Bitboard game core. Each player owns a 9-bit mask, bit i is gameBoard index i + 1
+// (bit 0 is the top left box, bit 8 the bottom right box).
+typedef struct {
+	unsigned short x; // Boxes taken by X
+	unsigned short o; // Boxes taken by O
+} GameBoard;
+
+#define BOARD_CELLS 9
+#define BOARD_FULL 0x1FF // Every box taken
+
+// Results returned by check_winner
+#define NO_WINNER 0
+#define X_WINS 1
+#define O_WINS 2
+#define DRAW 3
+
+#define NO_LINE -1 // Line reported when nobody completed three in a row
+
+extern const unsigned short winMasks[8]; // The 8 winning lines: columns, rows, then diagonals
+extern const unsigned char winLine[512]; // 1 + first winning line inside a mask, 0 if there is none
+
+// Bit mask of the boxes nobody has claimed yet
+static inline unsigned short board_empty(GameBoard board) {
+	return ~(board.x | board.o) & BOARD_FULL;
+}
+
+// Number of pieces on the board
+static inline int board_count(GameBoard board) {
+	return __builtin_popcount(board.x | board.o);
+}
+
+// Puts the current player's piece on box index (0-8)
+static inline void board_place(GameBoard *board, int index, char turn) {
+	if (turn == 'X'){
+		board->x |= 1 << index;
+	} else {
+		board->o |= 1 << index;
+	}
+}
+
+// Returns what sits on box index (0-8): 0 means empty, 1 means X, 2 means O
+static inline int board_at(GameBoard board, int index) {
+	return ((board.x >> index) & 1) | (((board.o >> index) & 1) << 1);
+}
+
+// Returns NO_WINNER, X_WINS, O_WINS or DRAW
+static inline int board_winner(GameBoard board) {
+	if (winLine[board.x]){
+		return X_WINS;
+	}
+	if (winLine[board.o]){
+		return O_WINS;
+	}
+	if (board_count(board) == BOARD_CELLS){
+		return DRAW;
+	}
+	return NO_WINNER;
+}
+
+// Pure evaluation with no side effects: returns the same codes as board_winner and
+// stores the index of the winning line in winMasks (or NO_LINE) into *line
+static inline int board_evaluate(GameBoard board, int *line) {
+	*line = winLine[board.x] - 1;
+	if (*line != NO_LINE){
+		return X_WINS;
+	}
+	*line = winLine[board.o] - 1;
+	if (*line != NO_LINE){
+		return O_WINS;
+	}
+	if (board_count(board) == BOARD_CELLS){
+		return DRAW;
+	}
+	return NO_WINNER;
+}
+
+// Rules of one move, shared by the Enter handler and the headless tools: puts turn's
+// piece on box index (0-8), evaluates the board and hands the turn over if the game goes on.
+// Returns -1 when the box is taken, otherwise the board_evaluate result.
+static inline int game_move(GameBoard *board, int index, char *turn, int *line) {
+	int winner;
+	if (!(board_empty(*board) & (1 << index))){
+		return -1;
+	}
+	board_place(board, index, *turn);
+	winner = board_evaluate(*board, line);
+	if (winner == NO_WINNER){
+		*turn = *turn == 'X' ? 'O' : 'X';
+	}
+	return winner;
+}
+
+#endif
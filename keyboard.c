@@ -0,0 +1,55 @@
+#include <string.h> // Include String Library for memset
+
+#include "keyboard.h"
+
+// Decoder states, the prefix bits combine
+#define STATE_EXTENDED 0x01 // E0 seen
+#define STATE_BREAK 0x02 // F0 seen
+
+#define PAUSE_LENGTH 7 // Pause is E1 14 77 E1 F0 14 F0 77 and never repeats or releases
+
+void keyboard_init(Keyboard *keyboard) {
+	memset(keyboard, 0, sizeof(*keyboard));
+}
+
+bool keyboard_decode(Keyboard *keyboard, unsigned char byte, KeyEvent *event) {
+	unsigned int key, bit;
+
+	if (keyboard->skip){
+		keyboard->skip--;
+		return false;
+	}
+
+	switch (byte){
+	case 0xE0:
+		keyboard->state |= STATE_EXTENDED;
+		return false;
+	case 0xF0:
+		keyboard->state |= STATE_BREAK;
+		return false;
+	case 0xE1:
+		keyboard->state = 0;
+		keyboard->skip = PAUSE_LENGTH;
+		return false;
+	// Replies and errors from the keyboard itself: buffer overrun, self-test passed,
+	// echo, acknowledge, resend
+	case 0x00: case 0xAA: case 0xEE: case 0xFA: case 0xFE: case 0xFF:
+		keyboard->state = 0;
+		return false;
+	}
+
+	event->code = byte;
+	event->extended = keyboard->state & STATE_EXTENDED;
+	event->released = keyboard->state & STATE_BREAK;
+	keyboard->state = 0;
+
+	key = (event->extended << 8) | byte;
+	bit = 1u << (key & 31);
+	event->repeat = !event->released && (keyboard->held[key >> 5] & bit);
+	if (event->released){
+		keyboard->held[key >> 5] &= ~bit;
+	} else {
+		keyboard->held[key >> 5] |= bit;
+	}
+	return true;
+}
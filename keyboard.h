@@ -0,0 +1,27 @@
+#ifndef KEYBOARD_H
+#define KEYBOARD_H
+
+#include <stdbool.h> // Include Standard Boolean Library for boolean variables
+
+// PS/2 scancode set 2 decoder. A key press is its make code, a release is F0 followed by
+// the make code, and extended keys (arrows, keypad Enter, ...) put E0 in front of both.
+// Bytes go in one at a time; an event comes out once a code is complete. Keys that are
+// still held when their make code arrives again are the keyboard's typematic repeat.
+
+typedef struct {
+	unsigned char code; // Make code without prefixes
+	bool extended; // Came after E0
+	bool released; // Came after F0
+	bool repeat; // Pressed again while already held down
+} KeyEvent;
+
+typedef struct {
+	unsigned char state; // Prefixes seen so far for the current code
+	unsigned char skip; // Bytes left of a Pause sequence
+	unsigned int held[512 / 32]; // One bit per key, extended keys in the upper half
+} Keyboard;
+
+void keyboard_init(Keyboard *keyboard);
+bool keyboard_decode(Keyboard *keyboard, unsigned char byte, KeyEvent *event); // True once event is filled in
+
+#endif
@@ -0,0 +1,250 @@
+
+#include <math.h> // Include Math Library for the UCT formula
+#include <pthread.h> // Include POSIX threads for tree parallelism
+#include <stdatomic.h> // Include C11 atomics for the shared tree
+#include <stdlib.h> // Include Standard Library for malloc and free
+#include <time.h> // Include Time Library for the time budget
+
+#include "mcts.h"
+
+#define NOT_EXPANDED -1
+#define EXPANDING -2 // Another thread is creating the children
+#define ARENA_FULL -3 // No room left, playouts start from here from now on
+
+#define MAX_MOVES (MNK_MAX_SIDE * MNK_MAX_SIDE)
+#define MAX_DEPTH (MAX_MOVES + 1)
+
+const MctsOptions mctsDefaults = {1, 100000, 0, 1 << 21, 8, 1.4};
+
+typedef struct {
+	atomic_int visits; // Playouts through this node, counted when a thread goes down (virtual loss)
+	atomic_int score; // 2 per win, 1 per draw, for the player who played move
+	atomic_int firstChild; // Arena index of the first child, or one of the markers above
+	short childCount;
+	short move; // Bit index of the move that leads here
+} MctsNode;
+
+// Search shared by all threads
+static struct {
+	const MnkBoard *root;
+	const MctsOptions *options;
+	MctsNode *arena;
+	atomic_int arenaUsed;
+	atomic_llong playouts;
+	atomic_int stop;
+	double deadline;
+} tree;
+
+typedef struct {
+	unsigned long long seed;
+	pthread_t thread;
+} MctsWorker;
+
+static double now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static inline unsigned int next_random(unsigned long long *seed) {
+	*seed ^= *seed << 13;
+	*seed ^= *seed >> 7;
+	*seed ^= *seed << 17;
+	return (unsigned int)(*seed >> 32);
+}
+
+// Plays random moves until the game ends and returns the check_winner code.
+// Works on the caller's board copy and a stack array of empty squares, nothing is allocated.
+static int playout(MnkBoard *board, unsigned long long *seed) {
+	short moves[MAX_MOVES];
+	int count = 0, word, result = 0;
+	MnkBits empty = mnk_empty(board);
+
+	for (word = 0; word < MNK_WORDS; word++){
+		uint64_t bits;
+		for (bits = empty.word[word]; bits; bits &= bits - 1){
+			moves[count++] = word * 64 + __builtin_ctzll(bits);
+		}
+	}
+	while (!result && count > 0){
+		// Swap a random square to the end and play it
+		int pick = (int)(((unsigned long long)next_random(seed) * count) >> 32);
+		int move = moves[pick];
+		moves[pick] = moves[--count];
+		result = mnk_play(board, move);
+	}
+	return result;
+}
+
+// Creates a child for every empty square. Only one thread gets to do it.
+static void expand(MctsNode *node, const MnkBoard *board) {
+	MnkBits empty = mnk_empty(board);
+	int count = 0, first, word, expected = NOT_EXPANDED;
+
+	if (!atomic_compare_exchange_strong(&node->firstChild, &expected, EXPANDING)){
+		return;
+	}
+	for (word = 0; word < MNK_WORDS; word++){
+		count += __builtin_popcountll(empty.word[word]);
+	}
+	first = atomic_fetch_add(&tree.arenaUsed, count);
+	if (first + count > tree.options->arenaNodes){
+		atomic_store(&node->firstChild, ARENA_FULL);
+		return;
+	}
+	count = 0;
+	for (word = 0; word < MNK_WORDS; word++){
+		uint64_t bits;
+		for (bits = empty.word[word]; bits; bits &= bits - 1){
+			MctsNode *child = &tree.arena[first + count++];
+			atomic_init(&child->visits, 0);
+			atomic_init(&child->score, 0);
+			atomic_init(&child->firstChild, NOT_EXPANDED);
+			child->childCount = 0;
+			child->move = word * 64 + __builtin_ctzll(bits);
+		}
+	}
+	node->childCount = count;
+	atomic_store_explicit(&node->firstChild, first, memory_order_release);
+}
+
+// Child with the best UCT value, unvisited children first
+static MctsNode * select_child(MctsNode *node, int first) {
+	MctsNode *best = 0;
+	double bestValue = -1.0;
+	double logVisits = log((double)atomic_load_explicit(&node->visits, memory_order_relaxed) + 1.0);
+	int i;
+
+	for (i = 0; i < node->childCount; i++){
+		MctsNode *child = &tree.arena[first + i];
+		int visits = atomic_load_explicit(&child->visits, memory_order_relaxed);
+		double value;
+		if (visits == 0){
+			return child;
+		}
+		value = atomic_load_explicit(&child->score, memory_order_relaxed) / (2.0 * visits)
+			+ tree.options->exploration * sqrt(logVisits / visits);
+		if (value > bestValue){
+			bestValue = value;
+			best = child;
+		}
+	}
+	return best;
+}
+
+// One selection, expansion, playout and backup pass
+static void iterate(unsigned long long *seed) {
+	MctsNode *path[MAX_DEPTH];
+	MnkBoard board = *tree.root;
+	MctsNode *node = &tree.arena[0];
+	int rootPlayer = mnk_player(&board);
+	int depth = 0, result = 0, i;
+
+	path[depth++] = node;
+	atomic_fetch_add_explicit(&node->visits, 1, memory_order_relaxed);
+	while (!result){
+		int first = atomic_load_explicit(&node->firstChild, memory_order_acquire);
+		if (first == NOT_EXPANDED && (depth == 1
+			|| atomic_load_explicit(&node->visits, memory_order_relaxed) >= tree.options->expandVisits)){
+			expand(node, &board);
+			first = atomic_load_explicit(&node->firstChild, memory_order_acquire);
+		}
+		if (first < 0){
+			break;
+		}
+		node = select_child(node, first);
+		// Virtual loss: the visit counts now, the score only after the playout
+		atomic_fetch_add_explicit(&node->visits, 1, memory_order_relaxed);
+		path[depth++] = node;
+		result = mnk_play(&board, node->move);
+	}
+	if (!result){
+		result = playout(&board, seed);
+	}
+
+	// Node i was reached by a move of the root player when i is odd
+	for (i = 1; i < depth; i++){
+		int mover = (i & 1) ? rootPlayer : !rootPlayer;
+		int reward = result == 3 ? 1 : result == mover + 1 ? 2 : 0;
+		atomic_fetch_add_explicit(&path[i]->score, reward, memory_order_relaxed);
+	}
+}
+
+static void * worker_main(void *arg) {
+	MctsWorker *worker = arg;
+	long long done = 0;
+	while (!atomic_load_explicit(&tree.stop, memory_order_relaxed)){
+		iterate(&worker->seed);
+		done = atomic_fetch_add_explicit(&tree.playouts, 1, memory_order_relaxed) + 1;
+		if (tree.options->playouts && done >= tree.options->playouts){
+			atomic_store(&tree.stop, 1);
+		}
+		// Checking the clock every playout would cost more than a small playout
+		if (tree.options->milliseconds && (done & 63) == 0 && now() >= tree.deadline){
+			atomic_store(&tree.stop, 1);
+		}
+	}
+	return 0;
+}
+
+int mcts_best_move(const MnkBoard *board, const MctsOptions *options, MctsStats *stats) {
+	MctsWorker workers[64];
+	MctsNode *root, *best = 0;
+	int threads = options->threads < 1 ? 1 : options->threads > 64 ? 64 : options->threads;
+	int first, i;
+	double start = now();
+
+	stats->playouts = 0;
+	stats->nodes = 0;
+	stats->seconds = 0;
+	stats->winRate = 0;
+	if (mnk_winner(board) != 0 || options->arenaNodes < 1 + board->cells){
+		return 0;
+	}
+
+	tree.root = board;
+	tree.options = options;
+	tree.arena = malloc(sizeof(MctsNode) * options->arenaNodes);
+	if (!tree.arena){
+		return 0;
+	}
+	atomic_store(&tree.arenaUsed, 1);
+	atomic_store(&tree.playouts, 0);
+	atomic_store(&tree.stop, !options->playouts && !options->milliseconds);
+	tree.deadline = start + options->milliseconds / 1000.0;
+	root = &tree.arena[0];
+	atomic_init(&root->visits, 0);
+	atomic_init(&root->score, 0);
+	atomic_init(&root->firstChild, NOT_EXPANDED);
+	root->childCount = 0;
+	root->move = -1;
+	expand(root, board);
+
+	for (i = 0; i < threads; i++){
+		workers[i].seed = 0x9E3779B97F4A7C15ULL * (i + 1);
+		pthread_create(&workers[i].thread, 0, worker_main, &workers[i]);
+	}
+	for (i = 0; i < threads; i++){
+		pthread_join(workers[i].thread, 0);
+	}
+
+	// Most visited child is the most reliable choice
+	first = atomic_load(&root->firstChild);
+	for (i = 0; i < root->childCount; i++){
+		MctsNode *child = &tree.arena[first + i];
+		if (!best || atomic_load(&child->visits) > atomic_load(&best->visits)){
+			best = child;
+		}
+	}
+
+	stats->playouts = atomic_load(&tree.playouts);
+	stats->nodes = atomic_load(&tree.arenaUsed);
+	if (stats->nodes > options->arenaNodes){
+		stats->nodes = options->arenaNodes;
+	}
+	stats->seconds = now() - start;
+	stats->winRate = atomic_load(&best->visits) ? atomic_load(&best->score) / (2.0 * atomic_load(&best->visits)) : 0;
+	i = mnk_index(board, best->move) + 1;
+	free(tree.arena);
+	return i;
+}
@@ -0,0 +1,32 @@
+#ifndef MCTS_H
+#define MCTS_H
+
+#include "mnk.h" // m,n,k variant engine
+
+// Monte Carlo Tree Search (UCT) player for boards too big to search exhaustively
+// (host only, uses pthreads). Threads share one tree and use virtual loss to spread
+// out over different branches. Tree nodes come from an arena sized up front.
+
+typedef struct {
+	int threads; // Threads working on the shared tree
+	long long playouts; // Stop after this many playouts (0 = no limit)
+	int milliseconds; // Stop after this much time (0 = no limit)
+	int arenaNodes; // Tree size limit, the tree stops growing when it is full
+	int expandVisits; // Visits a leaf needs before it gets children
+	double exploration; // UCT exploration constant
+} MctsOptions;
+
+typedef struct {
+	long long playouts; // Playouts run in total
+	int nodes; // Tree nodes used
+	double seconds; // Time spent thinking
+	double winRate; // Expected score of the chosen move for the player to move (draw = 0.5)
+} MctsStats;
+
+extern const MctsOptions mctsDefaults;
+
+// Picks a move for the player to move and returns it the way the Enter handler numbers
+// boxes: row * cols + col + 1. Returns 0 if the game is already over.
+int mcts_best_move(const MnkBoard *board, const MctsOptions *options, MctsStats *stats);
+
+#endif
@@ -0,0 +1,39 @@
+
+#include <string.h> // Include String Library for memset
+
+#include "mnk.h"
+
+bool mnk_init(MnkBoard *board, int rows, int cols, int k) {
+	int row, col;
+	if (rows < 1 || cols < 1 || rows > MNK_MAX_SIDE || cols > MNK_MAX_SIDE || k < 1 || (k > rows && k > cols)){
+		return false;
+	}
+	memset(board, 0, sizeof(*board));
+	board->rows = rows;
+	board->cols = cols;
+	board->k = k;
+	board->stride = cols + 1;
+	board->cells = rows * cols;
+	for (row = 0; row < rows; row++){
+		for (col = 0; col < cols; col++){
+			mnk_set(&board->valid, mnk_move(board, row, col));
+		}
+	}
+	return true;
+}
+
+// Checks the lines through every stone. Slow, only meant for positions loaded from outside.
+int mnk_winner(const MnkBoard *board) {
+	int player, word;
+	for (player = 0; player < 2; player++){
+		for (word = 0; word < MNK_WORDS; word++){
+			uint64_t bits;
+			for (bits = board->stones[player].word[word]; bits; bits &= bits - 1){
+				if (mnk_wins_at(board, player, word * 64 + __builtin_ctzll(bits))){
+					return player + 1;
+				}
+			}
+		}
+	}
+	return board->count == board->cells ? 3 : 0;
+}
@@ -0,0 +1,117 @@
+#ifndef MNK_H
+#define MNK_H
+
+#include <stdbool.h> // Include Standard Boolean Library for boolean variables
+#include <stdint.h> // Include fixed width integer types for the bitboards
+
+// Variant engine for m x n boards where k in a row wins (3,3,3 is the game on screen).
+// Each player owns a wide bitboard laid out row by row with one empty padding bit at
+// the end of every row, so a run of stones can never wrap from one row into the next.
+// A move is the bit index row * stride + col.
+
+#define MNK_MAX_SIDE 15 // Up to 15x15, enough for five in a row
+#define MNK_WORDS 4 // 64-bit words needed for 15 rows of 16 bits
+
+typedef struct {
+	uint64_t word[MNK_WORDS];
+} MnkBits;
+
+typedef struct {
+	int rows; // m
+	int cols; // n
+	int k; // Stones in a row needed to win
+	int stride; // cols + 1, bits from one row to the next
+	int cells; // rows * cols
+	int count; // Stones on the board
+	MnkBits stones[2]; // [0] is X, [1] is O
+	MnkBits valid; // Every bit that is a real square (padding excluded)
+} MnkBoard;
+
+// Read and write single squares
+static inline bool mnk_bit(const MnkBits *bits, int move) {
+	return (bits->word[move >> 6] >> (move & 63)) & 1;
+}
+
+static inline void mnk_set(MnkBits *bits, int move) {
+	bits->word[move >> 6] |= (uint64_t)1 << (move & 63);
+}
+
+static inline void mnk_clear(MnkBits *bits, int move) {
+	bits->word[move >> 6] &= ~((uint64_t)1 << (move & 63));
+}
+
+// Square to bit index and back. index is row * cols + col, like gameBoardIndex - 1 on the 3x3 board.
+static inline int mnk_move(const MnkBoard *board, int row, int col) {
+	return row * board->stride + col;
+}
+
+static inline int mnk_index(const MnkBoard *board, int move) {
+	return (move / board->stride) * board->cols + move % board->stride;
+}
+
+// 0 when X is to move, 1 when O is to move
+static inline int mnk_player(const MnkBoard *board) {
+	return board->count & 1;
+}
+
+static inline bool mnk_is_empty(const MnkBoard *board, int move) {
+	return mnk_bit(&board->valid, move) && !mnk_bit(&board->stones[0], move) && !mnk_bit(&board->stones[1], move);
+}
+
+// Bits of every empty square
+static inline MnkBits mnk_empty(const MnkBoard *board) {
+	MnkBits empty;
+	int i;
+	for (i = 0; i < MNK_WORDS; i++){
+		empty.word[i] = board->valid.word[i] & ~(board->stones[0].word[i] | board->stones[1].word[i]);
+	}
+	return empty;
+}
+
+// Length of the run of the player's stones through move along direction step, capped at k.
+// Only the line through move is looked at, at most k - 1 squares each way.
+static inline int mnk_run(const MnkBoard *board, const MnkBits *bits, int move, int step) {
+	int limit = board->rows * board->stride;
+	int run = 1;
+	int p;
+	for (p = move - step; run < board->k && p >= 0 && mnk_bit(bits, p); p -= step){
+		run++;
+	}
+	for (p = move + step; run < board->k && p < limit && mnk_bit(bits, p); p += step){
+		run++;
+	}
+	return run;
+}
+
+// True when the stone on move completes k in a row for player: checks the row,
+// the column and both diagonals through that square only
+static inline bool mnk_wins_at(const MnkBoard *board, int player, int move) {
+	const MnkBits *bits = &board->stones[player];
+	return mnk_run(board, bits, move, 1) >= board->k
+		|| mnk_run(board, bits, move, board->stride) >= board->k
+		|| mnk_run(board, bits, move, board->stride + 1) >= board->k
+		|| mnk_run(board, bits, move, board->stride - 1) >= board->k;
+}
+
+// Puts the next player's stone on move and returns NO_WINNER (0), X_WINS (1), O_WINS (2)
+// or DRAW (3), the same codes check_winner uses. move must be empty.
+static inline int mnk_play(MnkBoard *board, int move) {
+	int player = mnk_player(board);
+	mnk_set(&board->stones[player], move);
+	board->count++;
+	if (mnk_wins_at(board, player, move)){
+		return player + 1;
+	}
+	return board->count == board->cells ? 3 : 0;
+}
+
+// Takes back the last stone, which was played on move
+static inline void mnk_undo(MnkBoard *board, int move) {
+	board->count--;
+	mnk_clear(&board->stones[mnk_player(board)], move);
+}
+
+bool mnk_init(MnkBoard *board, int rows, int cols, int k); // Empty board, false if the size is unsupported
+int mnk_winner(const MnkBoard *board); // Full rescan for boards not built move by move
+
+#endif
@@ -0,0 +1,73 @@
+#include <stdio.h> // Include Standard Input Output Library for printf
+#include <string.h> // Include String Library for memset
+
+#include "profile.h"
+
+static ProfileHistogram histograms[PROFILE_COUNT];
+
+static const char *const probeNames[PROFILE_COUNT] = {
+	"irq", "decode", "action", "winner", "ai", "repaint", "swap", "text", "latency"
+};
+
+void profile_record(int probe, unsigned int cycles) {
+	ProfileHistogram *histogram = &histograms[probe];
+	int bucket = cycles ? 32 - __builtin_clz(cycles) : 0;
+	unsigned int worst = __atomic_load_n(&histogram->worst, __ATOMIC_RELAXED);
+
+	if (bucket >= PROFILE_BUCKETS){
+		bucket = PROFILE_BUCKETS - 1;
+	}
+	__atomic_fetch_add(&histogram->buckets[bucket], 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&histogram->total, cycles, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&histogram->count, 1, __ATOMIC_RELAXED);
+
+	// Retry only if someone else raised worst in between
+	while (cycles > worst && !__atomic_compare_exchange_n(&histogram->worst, &worst, cycles,
+		false, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+// Upper end of the bucket holding the given fraction of the samples
+static unsigned int percentile(const unsigned int *buckets, unsigned int count, unsigned int perMille) {
+	unsigned int seen = 0, wanted = (unsigned long long)count * perMille / 1000;
+	int b;
+	for (b = 0; b < PROFILE_BUCKETS - 1; b++){
+		seen += buckets[b];
+		if (seen > wanted){
+			break;
+		}
+	}
+	return b ? (1u << b) - 1 : 0;
+}
+
+// Copies each histogram before printing, samples recorded meanwhile may be half counted
+void profile_dump(void) {
+	ProfileHistogram copy;
+	unsigned int perUs = device_cycles_per_us();
+	int probe, b;
+
+	printf("profile in cycles (%u per us): count, average, p50 <=, p99 <=, worst\n", perUs);
+	for (probe = 0; probe < PROFILE_COUNT; probe++){
+		copy.count = __atomic_load_n(&histograms[probe].count, __ATOMIC_RELAXED);
+		if (copy.count == 0){
+			continue;
+		}
+		copy.total = __atomic_load_n(&histograms[probe].total, __ATOMIC_RELAXED);
+		copy.worst = __atomic_load_n(&histograms[probe].worst, __ATOMIC_RELAXED);
+		for (b = 0; b < PROFILE_BUCKETS; b++){
+			copy.buckets[b] = __atomic_load_n(&histograms[probe].buckets[b], __ATOMIC_RELAXED);
+		}
+
+		printf("%-8s %8u %10llu %10u %10u %10u (worst %u us)\n", probeNames[probe], copy.count,
+			copy.total / copy.count, percentile(copy.buckets, copy.count, 500),
+			percentile(copy.buckets, copy.count, 990), copy.worst, copy.worst / perUs);
+		for (b = 0; b < PROFILE_BUCKETS; b++){
+			if (copy.buckets[b]){
+				printf("         < 2^%-2d %u\n", b, copy.buckets[b]);
+			}
+		}
+	}
+}
+
+void profile_reset(void) {
+	memset(histograms, 0, sizeof(histograms));
+}
@@ -0,0 +1,45 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include "device.h" // device_cycles
+
+// Cycle histograms for the phases a key press goes through. Every probe owns a fixed
+// histogram with one bucket per power of two, so recording is a few atomic adds and
+// works the same from the IRQ handler and the main loop without locks. Cycles come from
+// the PMU cycle counter on the A9 and from clock_gettime (nanoseconds) on the host.
+
+enum {
+	PROFILE_IRQ, // Whole IRQ handler, from the exception entry
+	PROFILE_DECODE, // One scancode byte through the decoder
+	PROFILE_ACTION, // One key press applied to the game
+	PROFILE_WINNER, // Placing a piece and checking for a winner
+	PROFILE_AI, // Computer choosing its move
+	PROFILE_REPAINT, // One dirty rectangle redrawn by the render_* functions
+	PROFILE_SWAP, // Waiting for the buffer swap at vertical sync
+	PROFILE_TEXT, // Character buffer update
+	PROFILE_LATENCY, // Key interrupt until the frame showing it is on screen
+	PROFILE_COUNT
+};
+
+#define PROFILE_BUCKETS 32 // Bucket b counts samples of 2^(b-1) up to 2^b - 1 cycles
+
+typedef struct {
+	unsigned int count;
+	unsigned int worst;
+	unsigned long long total;
+	unsigned int buckets[PROFILE_BUCKETS];
+} ProfileHistogram;
+
+void profile_record(int probe, unsigned int cycles); // Adds one sample, safe from the IRQ handler
+void profile_dump(void); // Prints every probe that has samples
+void profile_reset(void); // Empties every histogram
+
+static inline unsigned int profile_begin(void) {
+	return device_cycles();
+}
+
+static inline void profile_end(int probe, unsigned int start) {
+	profile_record(probe, device_cycles() - start);
+}
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <stdint.h> // Include fixed width integer types for the wire format
+
+// Messages between server.c and its clients over a Unix domain stream socket. Every
+// request is 8 bytes and every reply 20, so both sides read and write whole arrays of
+// them and never parse lengths. Numbers are in the byte order of the machine, which is
+// the only one a Unix domain socket can reach. A client may send several requests
+// before reading the replies; they come back in the same order, each with the tag of
+// its request.
+//
+// Each connection owns one session, opened when the server accepts it and closed when
+// it hangs up. Requests take effect in the order they were sent, and every reply carries
+// the session's state right after its own request. Moves of different connections that
+// arrive together still go through session_apply_moves as one batch.
+
+#define PROTOCOL_SOCKET "/tmp/tictactoe.sock" // Default path of the server socket
+
+// Request types
+#define PROTOCOL_MOVE 1 // Play box cell (0-8) for whoever's turn it is, the computer answers straight away if it plays O
+#define PROTOCOL_NEW_GAME 2 // Clear the board, scores stay
+#define PROTOCOL_STATE 3 // Board, turn and result
+#define PROTOCOL_SCOREBOARD 4 // Scores and games played
+#define PROTOCOL_COMPUTER 5 // cell 1 makes the computer play O, 0 makes it two players
+
+// Reply result besides the board_evaluate results and SESSION_ILLEGAL
+#define PROTOCOL_BAD_REQUEST -2 // Unknown request type
+
+typedef struct {
+	uint8_t type; // PROTOCOL_* request type
+	uint8_t cell; // Box for PROTOCOL_MOVE, on/off for PROTOCOL_COMPUTER
+	uint16_t reserved; // Zero
+	uint32_t tag; // Any value, copied into the reply
+} ProtocolRequest;
+
+typedef struct {
+	uint32_t tag; // Tag of the request
+	uint8_t type; // Request type
+	int8_t result; // Result of a move (NO_WINNER, X_WINS, ...) or SESSION_ILLEGAL, otherwise the game's current result
+	uint8_t turn; // 'X' or 'O'
+	uint8_t flags; // SESSION_* flags
+	uint16_t x, o; // Occupancy masks, bit i is box i
+	uint16_t xScore, OScore;
+	uint32_t totalMatchesPlayed;
+} ProtocolReply;
+
+_Static_assert(sizeof(ProtocolRequest) == 8, "requests are 8 bytes on the wire");
+_Static_assert(sizeof(ProtocolReply) == 20, "replies are 20 bytes on the wire");
+
+#endif
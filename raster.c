@@ -0,0 +1,181 @@
+#include <stdlib.h> // Include Standard Library for abs
+
+#include "device.h" // Screen size and row pitch
+#include "raster.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h> // Include NEON intrinsics for the A9
+#define RASTER_ALIGN 16
+#elif defined(__AVX__)
+#include <immintrin.h> // Include AVX intrinsics for the host
+#define RASTER_ALIGN 32
+#elif defined(__SSE2__)
+#include <emmintrin.h> // Include SSE2 intrinsics for the host
+#define RASTER_ALIGN 16
+#else
+#define RASTER_ALIGN 4
+#endif
+
+typedef uint32_t __attribute__((may_alias)) PixelPair; // Two pixels written with one store
+
+// Fills count pixels starting at pixel: single pixels up to the first aligned address,
+// full vectors for the middle, single pixels again for what is left
+static inline void fill_row(unsigned short *pixel, int count, unsigned short colour) {
+	while (count > 0 && ((uintptr_t)pixel & (RASTER_ALIGN - 1))){
+		*pixel++ = colour;
+		count--;
+	}
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+	uint16x8_t wide = vdupq_n_u16(colour);
+	for (; count >= 16; count -= 16, pixel += 16){
+		vst1q_u16(pixel, wide);
+		vst1q_u16(pixel + 8, wide);
+	}
+	for (; count >= 8; count -= 8, pixel += 8){
+		vst1q_u16(pixel, wide);
+	}
+#elif defined(__AVX__)
+	__m256i wide = _mm256_set1_epi16((short)colour);
+	for (; count >= 16; count -= 16, pixel += 16){
+		_mm256_store_si256((__m256i *)pixel, wide);
+	}
+	if (count >= 8){
+		_mm_store_si128((__m128i *)pixel, _mm256_castsi256_si128(wide));
+		count -= 8;
+		pixel += 8;
+	}
+#elif defined(__SSE2__)
+	__m128i wide = _mm_set1_epi16((short)colour);
+	for (; count >= 16; count -= 16, pixel += 16){
+		_mm_store_si128((__m128i *)pixel, wide);
+		_mm_store_si128((__m128i *)(pixel + 8), wide);
+	}
+	for (; count >= 8; count -= 8, pixel += 8){
+		_mm_store_si128((__m128i *)pixel, wide);
+	}
+#endif
+	PixelPair pair = colour | (uint32_t)colour << 16;
+	for (; count >= 2; count -= 2, pixel += 2){
+		*(PixelPair *)pixel = pair;
+	}
+	if (count){
+		*pixel = colour;
+	}
+}
+
+void raster_span(uintptr_t buffer, int x0, int x1, int y, unsigned short colour) {
+	fill_row((unsigned short *)(buffer + (y << 10) + (x0 << 1)), x1 - x0 + 1, colour);
+}
+
+void raster_rect(uintptr_t buffer, int x0, int y0, int x1, int y1, unsigned short colour) {
+	uintptr_t row = buffer + (y0 << 10) + (x0 << 1);
+	int y;
+	for (y = y0; y <= y1; y++, row += PIXEL_ROW_BYTES){
+		fill_row((unsigned short *)row, x1 - x0 + 1, colour);
+	}
+}
+
+void raster_clear(uintptr_t buffer, unsigned short colour) {
+	raster_rect(buffer, 0, 0, SCREEN_WIDTH - 1, SCREEN_HEIGHT - 1, colour);
+}
+
+// Clipped rectangle fill, returns the pixels written
+static int clipped_rect(uintptr_t buffer, const RasterRect *clip, int x0, int y0, int x1, int y1, unsigned short colour) {
+	if (x0 < clip->x0) x0 = clip->x0;
+	if (y0 < clip->y0) y0 = clip->y0;
+	if (x1 > clip->x1) x1 = clip->x1;
+	if (y1 > clip->y1) y1 = clip->y1;
+	if (x0 > x1 || y0 > y1){
+		return 0;
+	}
+	raster_rect(buffer, x0, y0, x1, y1, colour);
+	return (x1 - x0 + 1) * (y1 - y0 + 1);
+}
+
+int raster_line(uintptr_t buffer, const RasterRect *clip, int x0, int y0, int x1, int y1, int thickness, unsigned short colour) {
+	int before = (thickness - 1) / 2, after = thickness / 2; // Width on either side of the centre
+	int deltaX, deltaY, error, step, x, y, from, to, written = 0, temp;
+
+	// Nothing to do if the line misses the clip rectangle
+	if ((x0 < clip->x0 - after && x1 < clip->x0 - after) || (x0 > clip->x1 + before && x1 > clip->x1 + before) ||
+		(y0 < clip->y0 - after && y1 < clip->y0 - after) || (y0 > clip->y1 + before && y1 > clip->y1 + before)){
+		return 0;
+	}
+
+	if (y0 == y1){
+		return clipped_rect(buffer, clip, x0 < x1 ? x0 : x1, y0 - before, x0 < x1 ? x1 : x0, y0 + after, colour);
+	}
+	if (x0 == x1){
+		return clipped_rect(buffer, clip, x0 - before, y0 < y1 ? y0 : y1, x0 + after, y0 < y1 ? y1 : y0, colour);
+	}
+
+	// Bresenham, walking the longer axis from the lower end, same pixels render_line always drew
+	if (abs(y1 - y0) > abs(x1 - x0)){
+		if (y0 > y1){
+			temp = x0; x0 = x1; x1 = temp;
+			temp = y0; y0 = y1; y1 = temp;
+		}
+		deltaY = y1 - y0;
+		deltaX = abs(x1 - x0);
+		step = x0 < x1 ? 1 : -1;
+		error = -(deltaY / 2);
+		for (x = x0, y = y0; y <= y1; y++){
+			from = x - before < clip->x0 ? clip->x0 : x - before;
+			to = x + after > clip->x1 ? clip->x1 : x + after;
+			if (y >= clip->y0 && y <= clip->y1 && from <= to){
+				raster_span(buffer, from, to, y, colour);
+				written += to - from + 1;
+			}
+			error += deltaX;
+			if (error >= 0){
+				x += step;
+				error -= deltaY;
+			}
+		}
+	} else {
+		if (x0 > x1){
+			temp = x0; x0 = x1; x1 = temp;
+			temp = y0; y0 = y1; y1 = temp;
+		}
+		deltaX = x1 - x0;
+		deltaY = abs(y1 - y0);
+		step = y0 < y1 ? 1 : -1;
+		error = -(deltaX / 2);
+		for (x = x0, y = y0; x <= x1; x++){
+			if (x >= clip->x0 && x <= clip->x1){
+				from = y - before < clip->y0 ? clip->y0 : y - before;
+				to = y + after > clip->y1 ? clip->y1 : y + after;
+				for (temp = from; temp <= to; temp++){
+					*(unsigned short *)(buffer + (temp << 10) + (x << 1)) = colour;
+				}
+				written += to >= from ? to - from + 1 : 0;
+			}
+			error += deltaY;
+			if (error >= 0){
+				y += step;
+				error -= deltaX;
+			}
+		}
+	}
+	return written;
+}
+
+int raster_segments(uintptr_t buffer, const RasterRect *clip, const RasterSegment *segments, int count, int thickness, unsigned short colour) {
+	int i, written = 0;
+	for (i = 0; i < count; i++){
+		written += raster_line(buffer, clip, segments[i].x0, segments[i].y0, segments[i].x1, segments[i].y1, thickness, colour);
+	}
+	return written;
+}
+
+const char * raster_isa(void) {
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+	return "NEON";
+#elif defined(__AVX__)
+	return "AVX";
+#elif defined(__SSE2__)
+	return "SSE2";
+#else
+	return "32-bit";
+#endif
+}
@@ -0,0 +1,33 @@
+#ifndef RASTER_H
+#define RASTER_H
+
+#include <stdint.h> // Include fixed width integer types for buffer addresses
+
+// Fill and line primitives for a 320x240 RGB565 pixel buffer with 1024 byte rows (see device.h).
+// Fills write row by row with the widest stores the CPU has: NEON on the A9, AVX or SSE2
+// on the host, 32-bit pairs of pixels anywhere else. Coordinates are inclusive. Fills must
+// already lie on the screen, lines are clipped to the rectangle they are given.
+
+typedef struct {
+	short x0, y0; // Top left corner
+	short x1, y1; // Bottom right corner
+} RasterRect;
+
+typedef struct {
+	short x0, y0; // Start
+	short x1, y1; // End
+} RasterSegment;
+
+void raster_span(uintptr_t buffer, int x0, int x1, int y, unsigned short colour); // One row from x0 to x1
+void raster_rect(uintptr_t buffer, int x0, int y0, int x1, int y1, unsigned short colour); // Filled rectangle
+void raster_clear(uintptr_t buffer, unsigned short colour); // Whole screen
+
+// Lines return the number of pixels written. Horizontal and vertical lines become one
+// rectangle fill, anything else is Bresenham with a run of thickness pixels across every
+// step. Thick lines are centred on the segment.
+int raster_line(uintptr_t buffer, const RasterRect *clip, int x0, int y0, int x1, int y1, int thickness, unsigned short colour);
+int raster_segments(uintptr_t buffer, const RasterRect *clip, const RasterSegment *segments, int count, int thickness, unsigned short colour);
+
+const char * raster_isa(void); // Name of the store path compiled in, for reports
+
+#endif
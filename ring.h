@@ -0,0 +1,48 @@
+#ifndef RING_H
+#define RING_H
+
+#include <stdbool.h> // Include Standard Boolean Library for boolean variables
+
+// Single-producer, single-consumer byte queue between keygameBoard_ISR and the main loop.
+// head only moves in the producer and tail only in the consumer, so neither side needs
+// a lock or has to turn interrupts off. Both count up forever and are masked on use.
+// Release/acquire ordering makes sure a byte is in data before head says it is there.
+
+#define RING_SIZE 256 // Power of two, same depth as the PS/2 FIFO
+
+typedef struct {
+	unsigned int head; // Bytes pushed so far, written by the producer
+	unsigned int tail; // Bytes popped so far, written by the consumer
+	unsigned int dropped; // Bytes lost because the queue was full, written by the producer
+	unsigned char data[RING_SIZE];
+} ByteRing;
+
+// Producer side, returns false and counts the byte as dropped if the queue is full
+static inline bool ring_push(ByteRing *ring, unsigned char byte) {
+	unsigned int head = ring->head;
+	if (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) == RING_SIZE){
+		ring->dropped++;
+		return false;
+	}
+	ring->data[head & (RING_SIZE - 1)] = byte;
+	__atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+	return true;
+}
+
+// Bytes waiting, safe to call from either side
+static inline unsigned int ring_count(const ByteRing *ring) {
+	return __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+}
+
+// Consumer side, returns false if there is nothing to take
+static inline bool ring_pop(ByteRing *ring, unsigned char *byte) {
+	unsigned int tail = ring->tail;
+	if (tail == __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE)){
+		return false;
+	}
+	*byte = ring->data[tail & (RING_SIZE - 1)];
+	__atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+	return true;
+}
+
+#endif
@@ -0,0 +1,237 @@
+
+#include <string.h> // Include String Library for memset
+
+#include "search.h"
+
+// Transposition table bounds
+#define TT_EXACT 0
+#define TT_LOWER 1 // Value is at least the stored score
+#define TT_UPPER 2 // Value is at most the stored score
+
+#define TT_SIZE (1 << SEARCH_TT_BITS)
+
+typedef struct {
+	unsigned long long key; // Full canonical key, 0 means empty
+	signed char score;
+	unsigned char flag;
+	unsigned char move; // Best move, in the frame of the symmetry that gave the key
+} TTEntry;
+
+// Box (row * 3 + col) each box moves to: identity, 3 rotations, 2 flips, 2 diagonal mirrors
+const unsigned char symmetrySquare[8][BOARD_CELLS] = {
+	{0, 1, 2, 3, 4, 5, 6, 7, 8}, // identity
+	{2, 5, 8, 1, 4, 7, 0, 3, 6}, // rotate 90
+	{8, 7, 6, 5, 4, 3, 2, 1, 0}, // rotate 180
+	{6, 3, 0, 7, 4, 1, 8, 5, 2}, // rotate 270
+	{2, 1, 0, 5, 4, 3, 8, 7, 6}, // mirror left-right
+	{6, 7, 8, 3, 4, 5, 0, 1, 2}, // mirror top-bottom
+	{0, 3, 6, 1, 4, 7, 2, 5, 8}, // mirror on the left diagonal
+	{8, 5, 2, 7, 4, 1, 6, 3, 0} // mirror on the right diagonal
+};
+
+unsigned short symmetryMask[8][512];
+static unsigned char inverseSquare[8][BOARD_CELLS];
+
+// Order in which moves are tried: centre, corners, then edges
+static const unsigned char moveOrder[BOARD_CELLS] = {4, 0, 2, 6, 8, 1, 3, 5, 7};
+
+const SearchOptions searchDefaults = {true, true, true, true};
+
+static unsigned long long zobrist[2][BOARD_CELLS]; // Random key per player and box
+static unsigned long long zobristTurn; // Mixed in when O is to move
+static TTEntry table[TT_SIZE];
+static SearchOptions options = {true, true, true, true};
+static SearchStats stats;
+
+// xorshift64, a fixed seed keeps the keys identical on every run
+static unsigned long long next_random(unsigned long long *state) {
+	*state ^= *state << 13;
+	*state ^= *state >> 7;
+	*state ^= *state << 17;
+	return *state;
+}
+
+void search_init(void) {
+	unsigned long long seed = 0x9E3779B97F4A7C15ULL;
+	int t, mask, square;
+
+	for (t = 0; t < 8; t++){
+		for (square = 0; square < BOARD_CELLS; square++){
+			inverseSquare[t][symmetrySquare[t][square]] = square;
+		}
+		for (mask = 0; mask < 512; mask++){
+			unsigned short mapped = 0;
+			for (square = 0; square < BOARD_CELLS; square++){
+				if (mask & (1 << square)){
+					mapped |= 1 << symmetrySquare[t][square];
+				}
+			}
+			symmetryMask[t][mask] = mapped;
+		}
+	}
+	for (square = 0; square < BOARD_CELLS; square++){
+		zobrist[0][square] = next_random(&seed);
+		zobrist[1][square] = next_random(&seed);
+	}
+	zobristTurn = next_random(&seed);
+	search_clear();
+}
+
+void search_clear(void) {
+	memset(table, 0, sizeof(table));
+	memset(&stats, 0, sizeof(stats));
+}
+
+void search_set_options(SearchOptions newOptions) {
+	options = newOptions;
+	search_clear();
+}
+
+SearchStats search_stats(void) {
+	return stats;
+}
+
+GameBoard search_canonical(GameBoard board) {
+	GameBoard best = board;
+	int t;
+	for (t = 1; t < 8; t++){
+		GameBoard mapped = {symmetryMask[t][board.x], symmetryMask[t][board.o]};
+		if (mapped.x < best.x || (mapped.x == best.x && mapped.o < best.o)){
+			best = mapped;
+		}
+	}
+	return best;
+}
+
+// hash[t] is the Zobrist key of the board seen through symmetry t, kept up to date move by move.
+// player is 0 when X is to move and 1 when O is to move.
+static int negamax(GameBoard board, int player, const unsigned long long *hash, int alpha, int beta, int *bestMove) {
+	int count = board_count(board);
+	int alphaOrig = alpha;
+	int best = -SEARCH_WIN - 1, bestSquare = -1, ttMove = -1;
+	int symmetries = options.symmetry ? 8 : 1;
+	int frame = 0, i, t;
+	unsigned long long key = 0;
+	TTEntry *entry = 0;
+	unsigned short empty;
+
+	stats.nodes++;
+
+	// The player who just moved completed a line
+	if (winLine[player ? board.x : board.o]){
+		return -(SEARCH_WIN - count);
+	}
+	if (count == BOARD_CELLS){
+		return 0;
+	}
+
+	if (options.transpositions){
+		// Canonical key is the smallest of the symmetric keys
+		key = hash[0];
+		for (t = 1; t < symmetries; t++){
+			if (hash[t] < key){
+				key = hash[t];
+				frame = t;
+			}
+		}
+		if (player){
+			key ^= zobristTurn;
+		}
+		key |= 1; // keep 0 free for empty slots, only the stored check value uses this bit
+		entry = &table[(key >> 1) & (TT_SIZE - 1)];
+		stats.ttProbes++;
+		if (entry->key == key){
+			stats.ttHits++;
+			ttMove = inverseSquare[frame][entry->move];
+			if (entry->flag == TT_EXACT
+				|| (entry->flag == TT_LOWER && entry->score >= beta)
+				|| (entry->flag == TT_UPPER && entry->score <= alpha)){
+				stats.ttCutoffs++;
+				if (bestMove){
+					*bestMove = ttMove;
+				}
+				return entry->score;
+			}
+		}
+	}
+
+	empty = board_empty(board);
+	for (i = -1; i < BOARD_CELLS; i++){
+		unsigned long long childHash[8];
+		GameBoard child = board;
+		int square, score;
+
+		// Table move first, then the fixed order (or plain box order without ordering)
+		if (i < 0){
+			if (!options.ordering || ttMove < 0){
+				continue;
+			}
+			square = ttMove;
+		} else {
+			square = options.ordering ? moveOrder[i] : i;
+			if (square == ttMove && options.ordering){
+				continue;
+			}
+		}
+		if (!(empty & (1 << square))){
+			continue;
+		}
+
+		if (player){
+			child.o |= 1 << square;
+		} else {
+			child.x |= 1 << square;
+		}
+		for (t = 0; t < symmetries; t++){
+			childHash[t] = hash[t] ^ zobrist[player][symmetrySquare[t][square]];
+		}
+
+		score = -negamax(child, !player, childHash, -beta, -alpha, 0);
+		if (score > best){
+			best = score;
+			bestSquare = square;
+		}
+		if (best > alpha){
+			alpha = best;
+		}
+		if (options.alphaBeta && alpha >= beta){
+			break;
+		}
+	}
+
+	if (entry){
+		entry->key = key;
+		entry->score = best;
+		entry->move = symmetrySquare[frame][bestSquare];
+		entry->flag = best <= alphaOrig ? TT_UPPER : best >= beta ? TT_LOWER : TT_EXACT;
+	}
+	if (bestMove){
+		*bestMove = bestSquare;
+	}
+	return best;
+}
+
+int search_best_move(GameBoard board, char turn, int *score) {
+	unsigned long long hash[8];
+	unsigned short pieces;
+	int move = -1, t;
+
+	if (board_winner(board) != NO_WINNER){
+		*score = 0;
+		return -1;
+	}
+
+	// Keys of the starting position under every symmetry
+	for (t = 0; t < 8; t++){
+		hash[t] = 0;
+		for (pieces = board.x; pieces; pieces &= pieces - 1){
+			hash[t] ^= zobrist[0][symmetrySquare[t][__builtin_ctz(pieces)]];
+		}
+		for (pieces = board.o; pieces; pieces &= pieces - 1){
+			hash[t] ^= zobrist[1][symmetrySquare[t][__builtin_ctz(pieces)]];
+		}
+	}
+
+	*score = negamax(board, turn == 'O', hash, -SEARCH_WIN - 1, SEARCH_WIN + 1, &move);
+	return move;
+}
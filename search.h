@@ -0,0 +1,47 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <stdbool.h> // Include Standard Boolean Library for boolean variables
+
+#include "game.h" // Bitboard game core
+
+// Negamax search with alpha-beta pruning, move ordering and a Zobrist-hashed
+// transposition table. Keys are taken under all 8 symmetries of the board so
+// rotated and mirrored positions share one table entry.
+
+#define SEARCH_WIN 10 // Score of a win with an empty board, every piece played costs one point
+#define SEARCH_TT_BITS 14 // Transposition table holds 1 << SEARCH_TT_BITS entries
+
+// Lets the search features be switched off one at a time to measure what each one saves
+typedef struct {
+	bool alphaBeta; // Prune with an alpha-beta window
+	bool ordering; // Try the table move, then centre, corners and edges first
+	bool transpositions; // Look positions up in the transposition table
+	bool symmetry; // Share table entries between the 8 symmetric positions
+} SearchOptions;
+
+// Counters collected while searching
+typedef struct {
+	unsigned long long nodes; // Positions visited
+	unsigned long long ttProbes; // Transposition table lookups
+	unsigned long long ttHits; // Lookups that found the position
+	unsigned long long ttCutoffs; // Hits that ended the search of a position
+} SearchStats;
+
+extern const SearchOptions searchDefaults; // Everything switched on
+extern const unsigned char symmetrySquare[8][BOARD_CELLS]; // Where each box ends up under each symmetry
+extern unsigned short symmetryMask[8][512]; // Every 9-bit mask under each symmetry
+
+void search_init(void); // Builds the symmetry tables and Zobrist keys, call once
+void search_clear(void); // Empties the transposition table and resets the counters
+void search_set_options(SearchOptions options); // Switches features on or off, clears the table
+SearchStats search_stats(void); // Counters since the last search_clear
+
+// Best box (0-8) for the player whose turn it is, -1 if the game is over.
+// *score gets the value for that player: > 0 win, 0 draw, < 0 loss.
+int search_best_move(GameBoard board, char turn, int *score);
+
+// Smallest of the 8 symmetric versions of a board, used as its canonical form
+GameBoard search_canonical(GameBoard board);
+
+#endif
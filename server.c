@@ -0,0 +1,450 @@
+#define _GNU_SOURCE // accept4 is a Linux extension
+
+#include <errno.h> // Include Error Numbers for EAGAIN and EINTR
+#include <signal.h> // Include Signal Library to stop on Ctrl+C and ignore SIGPIPE
+#include <stdio.h> // Include Standard Input Output Library for the report
+#include <stdlib.h> // Include Standard Library for atoi and calloc
+#include <string.h> // Include String Library for memcpy and strerror
+#include <unistd.h> // Include POSIX Library for close and unlink
+#include <sys/epoll.h> // Include epoll for the event loop
+#include <sys/resource.h> // Include Resource Limits to allow one descriptor per connection
+#include <sys/socket.h> // Include Sockets Library for accept4 and listen
+#include <sys/uio.h> // Include Vector I/O for readv and writev
+#include <sys/un.h> // Include Unix Domain Sockets for sockaddr_un
+
+#include "protocol.h" // Requests and replies on the wire
+#include "session.h" // Session pool and the move rules
+
+// Local game service. Clients connect to a Unix domain socket and play through the
+// requests in protocol.h; each connection gets a session from a SessionPool, and moves go
+// through session_move, the same rules the board's Enter key uses.
+//
+// One thread runs an epoll loop. Every connection has a fixed ring for the bytes it sent
+// and one for the replies it has not taken yet, allocated with the connection table at
+// start, so serving a request allocates nothing. A round of the loop reads every socket
+// that is ready with one readv each, serves the requests it found, and writes each
+// connection's replies back with one writev.
+//
+// Requests are served in steps so every reply shows its session right after its own
+// request. A step answers each connection's requests in order up to its next move, then
+// plays those moves, at most one per session, as one session_apply_moves batch and
+// answers them. Connections that stopped at a move go on in the next step.
+// gcc -O2 -o tictactoe_server server.c session.c game.c ai_table.c
+// ./tictactoe_server [socket path] [max connections]
+
+#define SERVER_EVENTS 1024 // Events taken from epoll per round
+#define IN_BYTES 256 // Requests a connection can have waiting, 32 of them (power of 2)
+#define OUT_BYTES 1024 // Replies a connection can have waiting, 51 of them (power of 2)
+#define LISTENER ((uint32_t)-1) // epoll tag of the listening socket
+
+typedef struct {
+	int fd; // -1 while the slot is free
+	unsigned int events; // What epoll is watching for
+	unsigned int inHead, inTail; // Bytes taken and bytes received, free running
+	unsigned int outHead, outTail; // Bytes sent and bytes queued, free running
+	bool active; // Already in this round's list
+	unsigned char in[IN_BYTES];
+	unsigned char out[OUT_BYTES];
+} Connection;
+
+static SessionPool pool;
+static Connection *connections; // Indexed by session slot
+static int epollFd, listenFd;
+static volatile sig_atomic_t stopping;
+
+// Storage of one round, sized for the worst case so nothing is allocated while serving
+static struct epoll_event events[SERVER_EVENTS];
+static unsigned int *activeList, *carryList, *stepList; // One entry per connection, allocated at start
+static int carryCount; // Connections with requests left over for lack of reply room
+static ProtocolRequest *moveRequests; // One step's moves, at most one per connection, allocated at start
+static SessionMove *moves;
+static signed char *results;
+
+static unsigned long long accepted, refused, served, rounds, batches, batchedMoves;
+
+static void on_signal(int signal) {
+	(void)signal;
+	stopping = 1;
+}
+
+static void close_connection(unsigned int slot) {
+	Connection *connection = &connections[slot];
+	if (connection->fd < 0){
+		return;
+	}
+	close(connection->fd); // Also takes it out of the epoll set
+	connection->fd = -1;
+	session_close(&pool, slot);
+}
+
+// Asks epoll for input only while there is room for it, and for output only while replies wait
+static void update_interest(unsigned int slot) {
+	Connection *connection = &connections[slot];
+	struct epoll_event event;
+	unsigned int wanted = 0;
+
+	if (connection->inTail - connection->inHead < IN_BYTES){
+		wanted |= EPOLLIN;
+	}
+	if (connection->outTail != connection->outHead){
+		wanted |= EPOLLOUT;
+	}
+	if (wanted != connection->events){
+		event.events = wanted;
+		event.data.u32 = slot;
+		if (epoll_ctl(epollFd, EPOLL_CTL_MOD, connection->fd, &event) < 0){
+			close_connection(slot);
+			return;
+		}
+		connection->events = wanted;
+	}
+}
+
+static void accept_connections(void) {
+	struct epoll_event event;
+	Connection *connection;
+	int fd, slot;
+
+	while ((fd = accept4(listenFd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0){
+		slot = session_open(&pool, false);
+		if (slot < 0){
+			close(fd); // Every session is taken
+			refused++;
+			continue;
+		}
+		connection = &connections[slot];
+		connection->fd = fd;
+		connection->events = EPOLLIN;
+		connection->inHead = connection->inTail = 0;
+		connection->outHead = connection->outTail = 0;
+		connection->active = false;
+
+		event.events = EPOLLIN;
+		event.data.u32 = slot;
+		if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) < 0){
+			close_connection(slot);
+			refused++;
+			continue;
+		}
+		accepted++;
+	}
+}
+
+// Fills the free part of the input ring, which may wrap, with one call
+static bool read_connection(Connection *connection) {
+	unsigned int used = connection->inTail - connection->inHead;
+	unsigned int start = connection->inTail & (IN_BYTES - 1);
+	unsigned int space = IN_BYTES - used;
+	struct iovec parts[2];
+	ssize_t length;
+
+	if (space == 0){
+		return true;
+	}
+	parts[0].iov_base = connection->in + start;
+	parts[0].iov_len = space < IN_BYTES - start ? space : IN_BYTES - start;
+	parts[1].iov_base = connection->in;
+	parts[1].iov_len = space - parts[0].iov_len;
+
+	length = readv(connection->fd, parts, parts[1].iov_len ? 2 : 1);
+	if (length > 0){
+		connection->inTail += length;
+		return true;
+	}
+	return length < 0 && (errno == EAGAIN || errno == EINTR); // 0 means the client hung up
+}
+
+// Sends the queued replies, which may wrap, with one call
+static bool write_connection(Connection *connection) {
+	unsigned int used = connection->outTail - connection->outHead;
+	unsigned int start = connection->outHead & (OUT_BYTES - 1);
+	struct iovec parts[2];
+	ssize_t length;
+
+	if (used == 0){
+		return true;
+	}
+	parts[0].iov_base = connection->out + start;
+	parts[0].iov_len = used < OUT_BYTES - start ? used : OUT_BYTES - start;
+	parts[1].iov_base = connection->out;
+	parts[1].iov_len = used - parts[0].iov_len;
+
+	length = writev(connection->fd, parts, parts[1].iov_len ? 2 : 1);
+	if (length >= 0){
+		connection->outHead += length;
+		return true;
+	}
+	return errno == EAGAIN || errno == EINTR;
+}
+
+static void ring_get(const unsigned char *ring, unsigned int size, unsigned int position, void *data, unsigned int length) {
+	unsigned int start = position & (size - 1);
+	unsigned int first = length < size - start ? length : size - start;
+	memcpy(data, ring + start, first);
+	memcpy((unsigned char *)data + first, ring, length - first);
+}
+
+static void ring_put(unsigned char *ring, unsigned int size, unsigned int position, const void *data, unsigned int length) {
+	unsigned int start = position & (size - 1);
+	unsigned int first = length < size - start ? length : size - start;
+	memcpy(ring + start, data, first);
+	memcpy(ring, (const unsigned char *)data + first, length - first);
+}
+
+// Answers a request with the session as it is now
+static void put_reply(unsigned int slot, const ProtocolRequest *request, int result) {
+	Connection *connection = &connections[slot];
+	const Session *session = session_get(&pool, slot);
+	ProtocolReply reply;
+
+	reply.tag = request->tag;
+	reply.type = request->type;
+	reply.result = result;
+	reply.turn = session->turn;
+	reply.flags = session->flags;
+	reply.x = session->board.x;
+	reply.o = session->board.o;
+	reply.xScore = session->xScore;
+	reply.OScore = session->OScore;
+	reply.totalMatchesPlayed = session->totalMatchesPlayed;
+
+	ring_put(connection->out, OUT_BYTES, connection->outTail, &reply, sizeof(reply));
+	connection->outTail += sizeof(reply);
+}
+
+// Serves a connection's whole requests in order, as many as its reply ring has room for,
+// up to the first move, which is added to the step's batch
+static void take_requests(unsigned int slot, int *moveCount) {
+	Connection *connection = &connections[slot];
+	Session *session = session_get(&pool, slot);
+	ProtocolRequest request;
+
+	// A move's reply is put after the batch, into the room checked for here
+	while (connection->inTail - connection->inHead >= sizeof(ProtocolRequest)
+		&& OUT_BYTES - (connection->outTail - connection->outHead) >= sizeof(ProtocolReply)){
+		ring_get(connection->in, IN_BYTES, connection->inHead, &request, sizeof(ProtocolRequest));
+		connection->inHead += sizeof(ProtocolRequest);
+		served++;
+
+		switch (request.type){
+			case PROTOCOL_MOVE:
+				if (request.cell >= BOARD_CELLS){
+					put_reply(slot, &request, SESSION_ILLEGAL); // Out of range, and must not read as SESSION_NEW_GAME
+					break;
+				}
+				// fall through
+			case PROTOCOL_NEW_GAME:
+				moves[*moveCount].session = slot;
+				moves[*moveCount].cell = request.type == PROTOCOL_MOVE ? request.cell : SESSION_NEW_GAME;
+				moveRequests[(*moveCount)++] = request;
+				return;
+			case PROTOCOL_COMPUTER:
+				if (request.cell){
+					session->flags |= SESSION_VS_COMPUTER;
+				} else {
+					session->flags &= ~SESSION_VS_COMPUTER;
+				}
+				put_reply(slot, &request, session->result);
+				break;
+			case PROTOCOL_STATE:
+			case PROTOCOL_SCOREBOARD:
+				put_reply(slot, &request, session->result);
+				break;
+			default:
+				put_reply(slot, &request, PROTOCOL_BAD_REQUEST);
+				break;
+		}
+	}
+}
+
+static void serve_round(int ready) {
+	Connection *connection;
+	bool listenerReady = false;
+	int activeCount = 0, stepCount = 0, moveCount, i;
+	unsigned int slot;
+
+	// Requests left over from the last round come first, as no event will announce them
+	for (i = 0; i < carryCount; i++){
+		connections[carryList[i]].active = true;
+		activeList[activeCount++] = carryList[i];
+	}
+	carryCount = 0;
+
+	// Read everything that arrived
+	for (i = 0; i < ready; i++){
+		slot = events[i].data.u32;
+		if (slot == LISTENER){
+			listenerReady = true; // Accepted after the round, so no slot is reused while its events are pending
+			continue;
+		}
+		connection = &connections[slot];
+		if (connection->fd < 0){
+			continue;
+		}
+		if ((events[i].events & EPOLLERR)
+			|| ((events[i].events & (EPOLLIN | EPOLLHUP)) && !read_connection(connection))
+			|| ((events[i].events & EPOLLOUT) && !write_connection(connection))){
+			close_connection(slot);
+			continue;
+		}
+		if (!connection->active){
+			connection->active = true;
+			activeList[activeCount++] = slot;
+		}
+	}
+
+	// Serve the requests in steps, the moves of every connection that reached one are a batch
+	for (i = 0; i < activeCount; i++){
+		if (connections[activeList[i]].fd >= 0){
+			stepList[stepCount++] = activeList[i];
+		}
+	}
+	while (stepCount > 0){
+		moveCount = 0;
+		for (i = 0; i < stepCount; i++){
+			take_requests(stepList[i], &moveCount);
+		}
+		session_apply_moves(&pool, moves, moveCount, results);
+		for (i = 0; i < moveCount; i++){
+			put_reply(moves[i].session, &moveRequests[i], results[i]);
+			stepList[i] = moves[i].session; // Only connections that stopped at a move have more to serve
+		}
+		stepCount = moveCount;
+		if (moveCount > 0){
+			batches++;
+			batchedMoves += moveCount;
+		}
+	}
+
+	// Send the replies
+	for (i = 0; i < activeCount; i++){
+		slot = activeList[i];
+		connection = &connections[slot];
+		connection->active = false;
+		if (connection->fd < 0){
+			continue;
+		}
+		if (!write_connection(connection)){
+			close_connection(slot);
+			continue;
+		}
+		update_interest(slot);
+		if (connection->fd >= 0 && connection->inTail - connection->inHead >= sizeof(ProtocolRequest)
+			&& OUT_BYTES - (connection->outTail - connection->outHead) >= sizeof(ProtocolReply)){
+			carryList[carryCount++] = slot;
+		}
+	}
+
+	if (listenerReady){
+		accept_connections();
+	}
+	rounds++;
+}
+
+static int listen_on(const char *path, int backlog) {
+	struct sockaddr_un address;
+	struct epoll_event event;
+	int fd;
+
+	if (strlen(path) >= sizeof(address.sun_path)){
+		fprintf(stderr, "socket path too long: %s\n", path);
+		return -1;
+	}
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	strcpy(address.sun_path, path);
+	unlink(path); // Left behind by a server that did not stop cleanly
+
+	fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (fd < 0 || bind(fd, (struct sockaddr *)&address, sizeof(address)) < 0 || listen(fd, backlog) < 0){
+		fprintf(stderr, "%s: %s\n", path, strerror(errno));
+		if (fd >= 0){
+			close(fd);
+		}
+		return -1;
+	}
+
+	event.events = EPOLLIN;
+	event.data.u32 = LISTENER;
+	if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) < 0){
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+int main(int argc, char **argv) {
+	const char *path = argc > 1 ? argv[1] : PROTOCOL_SOCKET;
+	unsigned int capacity = argc > 2 ? atoi(argv[2]) : 16384;
+	struct sigaction action;
+	struct rlimit limit;
+	unsigned int slot;
+	int ready;
+
+	// One descriptor per connection, plus the listener, epoll and stdio
+	if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < capacity + 16){
+		limit.rlim_cur = capacity + 16 < limit.rlim_max ? capacity + 16 : limit.rlim_max;
+		setrlimit(RLIMIT_NOFILE, &limit);
+	}
+
+	connections = calloc(capacity, sizeof(*connections));
+	activeList = calloc(capacity, sizeof(*activeList));
+	carryList = calloc(capacity, sizeof(*carryList));
+	stepList = calloc(capacity, sizeof(*stepList));
+	moveRequests = calloc(capacity, sizeof(*moveRequests));
+	moves = calloc(capacity, sizeof(*moves));
+	results = calloc(capacity, sizeof(*results));
+	if (capacity == 0 || !connections || !activeList || !carryList || !stepList || !moveRequests || !moves || !results
+		|| !session_pool_init(&pool, capacity)){
+		fprintf(stderr, "cannot allocate %u connections\n", capacity);
+		return 1;
+	}
+	for (slot = 0; slot < capacity; slot++){
+		connections[slot].fd = -1;
+	}
+
+	epollFd = epoll_create1(EPOLL_CLOEXEC);
+	if (epollFd < 0 || (listenFd = listen_on(path, SOMAXCONN)) < 0){
+		return 1;
+	}
+
+	// No SA_RESTART, so a signal wakes epoll_wait
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = on_signal;
+	sigaction(SIGINT, &action, NULL);
+	sigaction(SIGTERM, &action, NULL);
+	signal(SIGPIPE, SIG_IGN); // A client that hung up shows as an error from writev
+	printf("listening on %s, up to %u connections, %zu KB of buffers\n",
+		path, capacity, (size_t)capacity * sizeof(Connection) / 1024);
+	fflush(stdout);
+
+	while (!stopping){
+		ready = epoll_wait(epollFd, events, SERVER_EVENTS, carryCount ? 0 : -1);
+		if (ready < 0){
+			if (errno == EINTR){
+				continue;
+			}
+			fprintf(stderr, "epoll_wait: %s\n", strerror(errno));
+			break;
+		}
+		serve_round(ready);
+	}
+
+	printf("%llu connections accepted, %llu refused, %llu requests in %llu rounds, %llu batches, %.1f moves per batch\n",
+		accepted, refused, served, rounds, batches, batches ? (double)batchedMoves / batches : 0.0);
+	for (slot = 0; slot < capacity; slot++){
+		close_connection(slot);
+	}
+	close(listenFd);
+	close(epollFd);
+	unlink(path);
+	session_pool_free(&pool);
+	free(connections);
+	free(activeList);
+	free(carryList);
+	free(stepList);
+	free(moveRequests);
+	free(moves);
+	free(results);
+	return 0;
+}
@@ -0,0 +1,132 @@
+#include <stdlib.h> // Include Standard Library for aligned_alloc and free
+#include <string.h> // Include String Library for memset
+
+#include "ai.h" // Computer opponent
+#include "session.h"
+
+#define CACHE_LINE 64
+#define SESSION_PREFETCH 8 // How many moves ahead the batch loop prefetches
+
+_Static_assert(sizeof(Session) == 16, "four sessions should share a cache line");
+
+void session_init(Session *session, bool vsComputer) {
+	memset(session, 0, sizeof(*session));
+	session->turn = 'X';
+	session->flags = SESSION_OPEN | (vsComputer ? SESSION_VS_COMPUTER : 0);
+}
+
+void session_new_game(Session *session) {
+	session->board.x = 0;
+	session->board.o = 0;
+	session->turn = 'X';
+	session->result = NO_WINNER;
+	session->flags &= ~SESSION_DRAW;
+}
+
+int session_move(Session *session, int index, int *line) {
+	int winner;
+	*line = NO_LINE;
+	if (session->result != NO_WINNER || index < 0 || index >= BOARD_CELLS){
+		return SESSION_ILLEGAL;
+	}
+	winner = game_move(&session->board, index, &session->turn, line);
+	if (winner < 0){
+		return SESSION_ILLEGAL;
+	}
+
+	session->result = winner;
+	if (winner == X_WINS){
+		session->xScore++;
+	} else if (winner == O_WINS){
+		session->OScore++;
+	} else if (winner == DRAW){
+		session->flags |= SESSION_DRAW;
+	}
+	if (winner != NO_WINNER){
+		session->totalMatchesPlayed++;
+	}
+	return winner;
+}
+
+int session_computer_move(Session *session, int *line) {
+	int move = ai_best_move(session->board);
+	if (move == AI_NO_MOVE){
+		*line = NO_LINE;
+		return SESSION_ILLEGAL;
+	}
+	return session_move(session, move, line);
+}
+
+bool session_pool_init(SessionPool *pool, unsigned int capacity) {
+	size_t bytes = ((size_t)capacity * sizeof(Session) + CACHE_LINE - 1) & ~(size_t)(CACHE_LINE - 1);
+	unsigned int i;
+
+	pool->sessions = aligned_alloc(CACHE_LINE, bytes ? bytes : CACHE_LINE);
+	pool->freeSlots = malloc((size_t)capacity * sizeof(*pool->freeSlots));
+	if (!pool->sessions || !pool->freeSlots){
+		session_pool_free(pool);
+		return false;
+	}
+	memset(pool->sessions, 0, bytes);
+
+	// Hand out low slots first, so a pool that is mostly empty stays in few cache lines
+	for (i = 0; i < capacity; i++){
+		pool->freeSlots[i] = capacity - 1 - i;
+	}
+	pool->capacity = capacity;
+	pool->freeCount = capacity;
+	return true;
+}
+
+void session_pool_free(SessionPool *pool) {
+	free(pool->sessions);
+	free(pool->freeSlots);
+	pool->sessions = NULL;
+	pool->freeSlots = NULL;
+	pool->capacity = 0;
+	pool->freeCount = 0;
+}
+
+int session_open(SessionPool *pool, bool vsComputer) {
+	unsigned int slot;
+	if (pool->freeCount == 0){
+		return -1;
+	}
+	slot = pool->freeSlots[--pool->freeCount];
+	session_init(&pool->sessions[slot], vsComputer);
+	return slot;
+}
+
+void session_close(SessionPool *pool, unsigned int slot) {
+	if (slot < pool->capacity && (pool->sessions[slot].flags & SESSION_OPEN)){
+		pool->sessions[slot].flags = 0;
+		pool->freeSlots[pool->freeCount++] = slot;
+	}
+}
+
+void session_apply_moves(SessionPool *pool, const SessionMove *moves, int count, signed char *results) {
+	Session *session;
+	int i, line, result;
+
+	for (i = 0; i < count; i++){
+		if (i + SESSION_PREFETCH < count && moves[i + SESSION_PREFETCH].session < pool->capacity){
+			__builtin_prefetch(&pool->sessions[moves[i + SESSION_PREFETCH].session], 1);
+		}
+		if (moves[i].session >= pool->capacity || !(pool->sessions[moves[i].session].flags & SESSION_OPEN)){
+			results[i] = SESSION_ILLEGAL;
+			continue;
+		}
+		session = &pool->sessions[moves[i].session];
+
+		if (moves[i].cell == SESSION_NEW_GAME){
+			session_new_game(session);
+			results[i] = NO_WINNER;
+			continue;
+		}
+		result = session_move(session, moves[i].cell, &line);
+		if (result == NO_WINNER && (session->flags & SESSION_VS_COMPUTER) && session->turn == 'O'){
+			result = session_computer_move(session, &line);
+		}
+		results[i] = result;
+	}
+}
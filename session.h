@@ -0,0 +1,61 @@
+#ifndef SESSION_H
+#define SESSION_H
+
+#include <stdbool.h> // Include Standard Boolean Library for boolean variables
+
+#include "game.h" // Bitboard game core
+
+// Everything one game needs, so one process can run many of them. A Session is 16 bytes,
+// four to a cache line, and a SessionPool keeps them in one aligned block with a free
+// list of slots. Moves for many sessions are applied as a batch, which prefetches the
+// sessions a few moves ahead so their cache misses overlap.
+
+// Session flags
+#define SESSION_OPEN 0x01 // Slot is in use
+#define SESSION_VS_COMPUTER 0x02 // The computer plays O
+#define SESSION_DRAW 0x04 // Last game ended in a tie
+
+#define SESSION_NEW_GAME 0xFF // Move that clears the board instead of placing a piece
+#define SESSION_ILLEGAL -1 // Result of a move into a taken box, after the game ended or on a closed session
+
+typedef struct {
+	GameBoard board; // X and O occupancy masks
+	char turn; // Whose turn it is ('X' or 'O')
+	unsigned char selection; // Selected box (0-8)
+	unsigned char flags; // SESSION_* flags
+	unsigned char result; // board_evaluate result of the last move, NO_WINNER while the game goes on
+	unsigned short xScore; // Games won by X
+	unsigned short OScore; // Games won by O
+	unsigned int totalMatchesPlayed; // Games finished, including ties
+} Session;
+
+typedef struct {
+	Session *sessions; // capacity sessions, aligned to a cache line
+	unsigned int *freeSlots; // Unused slots, taken from the end
+	unsigned int capacity;
+	unsigned int freeCount;
+} SessionPool;
+
+typedef struct {
+	unsigned int session; // Slot in the pool
+	unsigned char cell; // Box (0-8) or SESSION_NEW_GAME
+} SessionMove;
+
+void session_init(Session *session, bool vsComputer); // Empty board, no scores, X to move
+void session_new_game(Session *session); // Clears the board and gives X the first move, scores stay
+int session_move(Session *session, int index, int *line); // Plays box index (0-8) for whoever's turn it is, counts the result
+int session_computer_move(Session *session, int *line); // Plays the computer's move, SESSION_ILLEGAL if there is none
+
+bool session_pool_init(SessionPool *pool, unsigned int capacity);
+void session_pool_free(SessionPool *pool);
+int session_open(SessionPool *pool, bool vsComputer); // Returns the slot, or -1 if the pool is full
+void session_close(SessionPool *pool, unsigned int slot);
+// Applies moves in order, results[i] gets the result of moves[i]. In sessions against the
+// computer its answer to a move is played straight away and its result replaces the move's.
+void session_apply_moves(SessionPool *pool, const SessionMove *moves, int count, signed char *results);
+
+static inline Session *session_get(SessionPool *pool, unsigned int slot) {
+	return &pool->sessions[slot];
+}
+
+#endif
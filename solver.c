@@ -0,0 +1,430 @@
+
+#include <pthread.h> // Include POSIX threads for the worker pool
+#include <sched.h> // Include sched_yield for idle workers
+#include <stdatomic.h> // Include C11 atomics for the deques and the shared table
+#include <stdlib.h> // Include Standard Library for calloc and free
+#include <string.h> // Include String Library for memset
+
+#include "solver.h"
+
+#define DEQUE_SIZE 4096 // A deque only ever holds the children of the nodes on one path
+
+// Shared table entry, one 64-bit word so it can be read and written without locks:
+// bits 0-47 the position (X squares, then O squares 24 bits higher), 48-49 score + 1,
+// 50-51 bound, 52 set when the slot is used
+#define TT_KEY_MASK (((uint64_t)1 << 48) - 1)
+#define TT_VALID ((uint64_t)1 << 52)
+#define TT_EXACT 0
+#define TT_LOWER 1 // Value is at least the stored score
+#define TT_UPPER 2 // Value is at most the stored score
+
+// A position above the split depth. Children report back through pending and best.
+typedef struct SolveNode {
+	MnkBoard board;
+	uint64_t key;
+	struct SolveNode *parent;
+	int move; // Square played from the parent, row * cols + col
+	int depth; // Plies below the root
+	atomic_int pending; // Children that have not reported yet
+	atomic_int best; // (score + 2) << 8 | square of the best child seen so far
+	atomic_int cut; // Set when a winning child was found, the other children can be skipped
+} SolveNode;
+
+// Chase-Lev work-stealing deque: the owner pushes and takes at the bottom,
+// other threads steal from the top
+typedef struct {
+	atomic_long top;
+	atomic_long bottom;
+	_Atomic(SolveNode *) slots[DEQUE_SIZE];
+} Deque;
+
+typedef struct {
+	int id;
+	unsigned long long seed; // Picks steal victims
+	Deque deque;
+	SolverThreadStats stats;
+	pthread_t thread;
+} Worker;
+
+// Everything one solver_run shares between its threads
+static struct {
+	int threads;
+	int splitDepth;
+	int order[MNK_MAX_SIDE * (MNK_MAX_SIDE + 1)]; // Squares sorted from the centre out
+	int orderCount;
+	int cellOf[MNK_MAX_SIDE * (MNK_MAX_SIDE + 1)]; // Bit index to row * cols + col
+	_Atomic uint64_t *table;
+	int ttBits;
+	SolveNode *pool; // Pre-sized, nodes are never freed during a run
+	atomic_long poolUsed;
+	long poolSize;
+	SolveNode *root;
+	atomic_int done;
+	Worker *workers;
+} solver;
+
+static void deque_push(Deque *deque, SolveNode *node) {
+	long bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+	long top = atomic_load_explicit(&deque->top, memory_order_acquire);
+	if (bottom - top >= DEQUE_SIZE){
+		abort(); // Cannot happen with DEQUE_SIZE larger than split depth * squares
+	}
+	atomic_store_explicit(&deque->slots[bottom % DEQUE_SIZE], node, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+	atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+}
+
+static SolveNode * deque_take(Deque *deque) {
+	long bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+	long top;
+	SolveNode *node = 0;
+
+	atomic_store_explicit(&deque->bottom, bottom, memory_order_relaxed);
+	atomic_thread_fence(memory_order_seq_cst);
+	top = atomic_load_explicit(&deque->top, memory_order_relaxed);
+	if (top <= bottom){
+		node = atomic_load_explicit(&deque->slots[bottom % DEQUE_SIZE], memory_order_relaxed);
+		if (top == bottom){
+			// Last task, race the thieves for it
+			if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1,
+				memory_order_seq_cst, memory_order_relaxed)){
+				node = 0;
+			}
+			atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+		}
+	} else {
+		atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+	}
+	return node;
+}
+
+static SolveNode * deque_steal(Deque *deque) {
+	long top = atomic_load_explicit(&deque->top, memory_order_acquire);
+	long bottom;
+	SolveNode *node;
+
+	atomic_thread_fence(memory_order_seq_cst);
+	bottom = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+	if (top >= bottom){
+		return 0;
+	}
+	node = atomic_load_explicit(&deque->slots[top % DEQUE_SIZE], memory_order_relaxed);
+	if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1,
+		memory_order_seq_cst, memory_order_relaxed)){
+		return 0; // Another thread got it first
+	}
+	return node;
+}
+
+static _Atomic uint64_t * tt_slot(uint64_t key) {
+	return &solver.table[(key * 0x9E3779B97F4A7C15ULL) >> (64 - solver.ttBits)];
+}
+
+// Sequential alpha-beta below the split depth. Scores are from the point of view
+// of the player to move: 1 win, 0 draw, -1 loss. The position is never over on entry.
+static int negamax(Worker *worker, MnkBoard *board, uint64_t key, int alpha, int beta) {
+	int player = mnk_player(board);
+	int alphaOrig = alpha;
+	int best = -2;
+	int i, flag;
+	int threats = 0, forced = -1;
+	_Atomic uint64_t *slot = tt_slot(key);
+	uint64_t entry;
+
+	worker->stats.nodes++;
+	worker->stats.ttProbes++;
+	entry = atomic_load_explicit(slot, memory_order_relaxed);
+	if ((entry & TT_VALID) && (entry & TT_KEY_MASK) == key){
+		int score = (int)((entry >> 48) & 3) - 1;
+		flag = (entry >> 50) & 3;
+		worker->stats.ttHits++;
+		if (flag == TT_EXACT || (flag == TT_LOWER && score >= beta) || (flag == TT_UPPER && score <= alpha)){
+			return score;
+		}
+	}
+
+	// Win on the spot if we can, and find the squares where the opponent would win next move
+	for (i = 0; i < solver.orderCount; i++){
+		int move = solver.order[i];
+		bool wins;
+		if (!mnk_is_empty(board, move)){
+			continue;
+		}
+		mnk_set(&board->stones[player], move);
+		wins = mnk_wins_at(board, player, move);
+		mnk_clear(&board->stones[player], move);
+		if (wins){
+			return 1;
+		}
+		mnk_set(&board->stones[!player], move);
+		if (mnk_wins_at(board, !player, move)){
+			threats++;
+			forced = move;
+		}
+		mnk_clear(&board->stones[!player], move);
+	}
+	// Two open threats cannot both be blocked
+	if (threats > 1){
+		return -1;
+	}
+
+	for (i = 0; i < solver.orderCount; i++){
+		int move = threats ? forced : solver.order[i];
+		int result, score;
+		if (!mnk_is_empty(board, move)){
+			continue;
+		}
+		result = mnk_play(board, move);
+		if (result == player + 1){
+			score = 1;
+		} else if (result == 3){
+			score = 0;
+		} else {
+			score = -negamax(worker, board, key | ((uint64_t)1 << (solver.cellOf[move] + player * 24)), -beta, -alpha);
+		}
+		mnk_undo(board, move);
+
+		if (score > best){
+			best = score;
+		}
+		if (best > alpha){
+			alpha = best;
+		}
+		if (alpha >= beta || threats){
+			break;
+		}
+	}
+
+	flag = best <= alphaOrig ? TT_UPPER : best >= beta ? TT_LOWER : TT_EXACT;
+	atomic_store_explicit(slot, key | ((uint64_t)(best + 1) << 48) | ((uint64_t)flag << 50) | TT_VALID,
+		memory_order_relaxed);
+	return best;
+}
+
+// Records a child's score (from node's point of view) if it is the best so far
+static void report(SolveNode *node, int score, int square) {
+	int packed = ((score + 2) << 8) | square;
+	int current = atomic_load(&node->best);
+	while (packed > current && !atomic_compare_exchange_weak(&node->best, &current, packed));
+	if (score == 1){
+		atomic_store(&node->cut, 1);
+	}
+}
+
+// A task whose result no longer matters because an ancestor already found a win
+static bool cancelled(SolveNode *node) {
+	SolveNode *ancestor;
+	for (ancestor = node->parent; ancestor; ancestor = ancestor->parent){
+		if (atomic_load_explicit(&ancestor->cut, memory_order_relaxed)){
+			return true;
+		}
+	}
+	return false;
+}
+
+// Called once all of node's children have reported or were cancelled. A node under a
+// cutoff, or one that got no result at all, has no proven value and only counts itself out.
+static void complete(SolveNode *node) {
+	int best = atomic_load(&node->best);
+	SolveNode *parent = node->parent;
+	if (!parent){
+		atomic_store(&solver.done, 1);
+		return;
+	}
+	if (best != 0 && !cancelled(node)){
+		report(parent, -((best >> 8) - 2), node->move);
+	}
+	if (atomic_fetch_sub(&parent->pending, 1) == 1){
+		complete(parent);
+	}
+}
+
+static void run_node(Worker *worker, SolveNode *node) {
+	int player = mnk_player(&node->board);
+	int i;
+
+	worker->stats.tasks++;
+	if (cancelled(node)){
+		if (atomic_fetch_sub(&node->parent->pending, 1) == 1){
+			complete(node->parent);
+		}
+		return;
+	}
+
+	// Below the split: solve the whole subtree on this thread
+	if (node->depth >= solver.splitDepth){
+		MnkBoard board = node->board;
+		report(node, negamax(worker, &board, node->key, -1, 1), 0);
+		complete(node);
+		return;
+	}
+
+	// Above the split: every child becomes a task. pending starts at 1 so the node
+	// cannot complete while children are still being pushed.
+	atomic_store(&node->pending, 1);
+	worker->stats.nodes++;
+	for (i = 0; i < solver.orderCount && !atomic_load_explicit(&node->cut, memory_order_relaxed); i++){
+		int move = solver.order[i];
+		MnkBoard board;
+		SolveNode *child;
+		int result;
+
+		if (!mnk_is_empty(&node->board, move)){
+			continue;
+		}
+		board = node->board;
+		result = mnk_play(&board, move);
+		if (result == player + 1){
+			report(node, 1, solver.cellOf[move]);
+			continue;
+		}
+		if (result == 3){
+			report(node, 0, solver.cellOf[move]);
+			continue;
+		}
+
+		child = &solver.pool[atomic_fetch_add(&solver.poolUsed, 1)];
+		child->board = board;
+		child->key = node->key | ((uint64_t)1 << (solver.cellOf[move] + player * 24));
+		child->parent = node;
+		child->move = solver.cellOf[move];
+		child->depth = node->depth + 1;
+		atomic_init(&child->pending, 0);
+		atomic_init(&child->best, 0);
+		atomic_init(&child->cut, 0);
+		atomic_fetch_add(&node->pending, 1);
+		deque_push(&worker->deque, child);
+	}
+	if (atomic_fetch_sub(&node->pending, 1) == 1){
+		complete(node);
+	}
+}
+
+static SolveNode * steal(Worker *worker) {
+	Worker *victim;
+	SolveNode *node;
+	if (solver.threads < 2){
+		return 0;
+	}
+	// xorshift64 to pick a victim other than ourselves
+	worker->seed ^= worker->seed << 13;
+	worker->seed ^= worker->seed >> 7;
+	worker->seed ^= worker->seed << 17;
+	victim = &solver.workers[(worker->id + 1 + worker->seed % (solver.threads - 1)) % solver.threads];
+	worker->stats.stealAttempts++;
+	node = deque_steal(&victim->deque);
+	if (node){
+		worker->stats.steals++;
+	}
+	return node;
+}
+
+static void * worker_main(void *arg) {
+	Worker *worker = arg;
+	while (!atomic_load_explicit(&solver.done, memory_order_acquire)){
+		SolveNode *node = deque_take(&worker->deque);
+		if (!node){
+			node = steal(worker);
+		}
+		if (node){
+			run_node(worker, node);
+		} else {
+			sched_yield();
+		}
+	}
+	return 0;
+}
+
+bool solver_run(const MnkBoard *board, int threads, int splitDepth, int ttBits, SolverResult *result) {
+	int row, col, i, j, empty;
+	long level;
+	int distance[MNK_MAX_SIDE * (MNK_MAX_SIDE + 1)];
+
+	if (board->cells > SOLVER_MAX_CELLS || threads < 1 || threads > SOLVER_MAX_THREADS
+		|| splitDepth < 1 || ttBits < 10 || ttBits > 34){
+		return false;
+	}
+	memset(result, 0, sizeof(*result));
+	result->threads = threads;
+	result->bestMove = -1;
+	if (mnk_winner(board) != 0){
+		return true;
+	}
+
+	// Try squares near the centre first, they take part in the most lines
+	solver.orderCount = 0;
+	for (row = 0; row < board->rows; row++){
+		for (col = 0; col < board->cols; col++){
+			int move = mnk_move(board, row, col);
+			int dr = 2 * row - (board->rows - 1), dc = 2 * col - (board->cols - 1);
+			distance[move] = dr * dr + dc * dc;
+			solver.cellOf[move] = row * board->cols + col;
+			for (i = solver.orderCount; i > 0 && distance[solver.order[i - 1]] > distance[move]; i--){
+				solver.order[i] = solver.order[i - 1];
+			}
+			solver.order[i] = move;
+			solver.orderCount++;
+		}
+	}
+
+	// Room for every node above the split
+	empty = board->cells - board->count;
+	solver.poolSize = 1;
+	level = 1;
+	for (i = 0; i < splitDepth && i < empty; i++){
+		level *= empty - i;
+		solver.poolSize += level;
+		if (solver.poolSize > 4000000){
+			return false;
+		}
+	}
+
+	solver.threads = threads;
+	solver.splitDepth = splitDepth;
+	solver.ttBits = ttBits;
+	solver.table = calloc((size_t)1 << ttBits, sizeof(uint64_t));
+	solver.pool = calloc(solver.poolSize, sizeof(SolveNode));
+	solver.workers = calloc(threads, sizeof(Worker));
+	if (!solver.table || !solver.pool || !solver.workers){
+		free(solver.table);
+		free(solver.pool);
+		free(solver.workers);
+		return false;
+	}
+	atomic_store(&solver.poolUsed, 1);
+	atomic_store(&solver.done, 0);
+
+	// The root goes on the first thread's deque, the others start by stealing
+	solver.root = &solver.pool[0];
+	solver.root->board = *board;
+	solver.root->key = 0;
+	for (i = 0; i < board->rows * board->stride; i++){
+		for (j = 0; j < 2; j++){
+			if (mnk_bit(&board->stones[j], i)){
+				solver.root->key |= (uint64_t)1 << (solver.cellOf[i] + j * 24);
+			}
+		}
+	}
+	for (i = 0; i < threads; i++){
+		solver.workers[i].id = i;
+		solver.workers[i].seed = 0x9E3779B97F4A7C15ULL * (i + 1);
+	}
+	deque_push(&solver.workers[0].deque, solver.root);
+
+	for (i = 0; i < threads; i++){
+		pthread_create(&solver.workers[i].thread, 0, worker_main, &solver.workers[i]);
+	}
+	for (i = 0; i < threads; i++){
+		pthread_join(solver.workers[i].thread, 0);
+		result->thread[i] = solver.workers[i].stats;
+	}
+
+	result->value = (atomic_load(&solver.root->best) >> 8) - 2;
+	result->bestMove = atomic_load(&solver.root->best) & 0xFF;
+	result->splitTasks = atomic_load(&solver.poolUsed);
+
+	free(solver.table);
+	free(solver.pool);
+	free(solver.workers);
+	return true;
+}
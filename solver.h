@@ -0,0 +1,37 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include "mnk.h" // m,n,k variant engine
+
+// Parallel solver for small m,n,k boards (host only, uses pthreads).
+// The first few plies are split into tasks that a pool of threads shares through
+// work-stealing deques; every task below the split is solved with alpha-beta and a
+// transposition table that all threads share without locks.
+
+#define SOLVER_MAX_THREADS 64
+#define SOLVER_MAX_CELLS 24 // Positions must fit the 48-bit table key (4x4, 5x4, 6x4 ...)
+
+// Per-thread counters
+typedef struct {
+	unsigned long long nodes; // Positions searched
+	unsigned long long tasks; // Tasks run
+	unsigned long long steals; // Tasks taken from another thread's deque
+	unsigned long long stealAttempts; // Steal attempts, including the ones that found nothing
+	unsigned long long ttProbes; // Transposition table lookups
+	unsigned long long ttHits; // Lookups that found the position
+} SolverThreadStats;
+
+typedef struct {
+	int value; // 1 the player to move wins, 0 draw, -1 the player to move loses
+	int bestMove; // Square (row * cols + col) that reaches value, -1 if the game is over
+	int threads;
+	unsigned long long splitTasks; // Tasks created above the split depth
+	SolverThreadStats thread[SOLVER_MAX_THREADS];
+} SolverResult;
+
+// Solves board with the given number of threads. Tasks are split off for the first
+// splitDepth plies and the shared table has 1 << ttBits entries.
+// Returns false if the board is too big or the settings are out of range.
+bool solver_run(const MnkBoard *board, int threads, int splitDepth, int ttBits, SolverResult *result);
+
+#endif
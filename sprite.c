@@ -0,0 +1,60 @@
+#include <string.h> // Include String Library for memset
+
+#include "device.h" // Row pitch
+#include "sprite.h"
+
+// Sprites are drawn here with the normal pixel layout and then scanned into runs
+static unsigned short scratch[SPRITE_HEIGHT * (PIXEL_ROW_BYTES / 2)];
+
+void sprite_build(Sprite *sprite, const RasterSegment *segments, int count, int thickness) {
+	const RasterRect bounds = {0, 0, SPRITE_WIDTH - 1, SPRITE_HEIGHT - 1};
+	unsigned short *row;
+	int x, y, start;
+
+	memset(scratch, 0, sizeof(scratch));
+	raster_segments((uintptr_t)scratch, &bounds, segments, count, thickness, 1);
+
+	sprite->count = 0;
+	for (y = 0; y < SPRITE_HEIGHT; y++){
+		row = scratch + y * (PIXEL_ROW_BYTES / 2);
+		for (x = 0; x < SPRITE_WIDTH; x++){
+			if (!row[x]){
+				continue;
+			}
+			for (start = x; x + 1 < SPRITE_WIDTH && row[x + 1]; x++);
+			if (sprite->count == SPRITE_MAX_RUNS){
+				return; // Too detailed for a sprite, the rest is left out
+			}
+			sprite->runs[sprite->count].row = y;
+			sprite->runs[sprite->count].x0 = start;
+			sprite->runs[sprite->count].x1 = x;
+			sprite->count++;
+		}
+	}
+}
+
+int sprite_blit(uintptr_t buffer, const RasterRect *clip, const Sprite *sprite, int x, int y, unsigned short colour) {
+	const SpriteRun *run = sprite->runs, *end = sprite->runs + sprite->count;
+	int row, x0, x1, written = 0;
+
+	// Nothing to do if the sprite misses the clip rectangle
+	if (x > clip->x1 || y > clip->y1 || x + SPRITE_WIDTH <= clip->x0 || y + SPRITE_HEIGHT <= clip->y0){
+		return 0;
+	}
+	for (; run < end; run++){
+		row = y + run->row;
+		if (row < clip->y0){
+			continue;
+		}
+		if (row > clip->y1){
+			break;
+		}
+		x0 = x + run->x0 < clip->x0 ? clip->x0 : x + run->x0;
+		x1 = x + run->x1 > clip->x1 ? clip->x1 : x + run->x1;
+		if (x0 <= x1){
+			raster_span(buffer, x0, x1, row, colour);
+			written += x1 - x0 + 1;
+		}
+	}
+	return written;
+}
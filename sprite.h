@@ -0,0 +1,26 @@
+#ifndef SPRITE_H
+#define SPRITE_H
+
+#include "raster.h" // Segments, clip rectangles and span fills
+
+// One-colour sprites stored as horizontal runs, row by row. A sprite is drawn once
+// with raster_line when it is built, after that every copy on screen is just spans.
+
+#define SPRITE_WIDTH 89 // A gameBoard box from its top left corner, outline excluded
+#define SPRITE_HEIGHT 62
+#define SPRITE_MAX_RUNS 256
+
+typedef struct {
+	unsigned char row; // Offset from the sprite origin
+	unsigned char x0, x1; // First and last pixel of the run
+} SpriteRun;
+
+typedef struct {
+	int count; // Runs in use
+	SpriteRun runs[SPRITE_MAX_RUNS]; // Sorted by row, then x
+} Sprite;
+
+void sprite_build(Sprite *sprite, const RasterSegment *segments, int count, int thickness); // Renders segments into runs
+int sprite_blit(uintptr_t buffer, const RasterRect *clip, const Sprite *sprite, int x, int y, unsigned short colour); // Returns pixels written
+
+#endif
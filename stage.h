@@ -0,0 +1,50 @@
+#ifndef STAGE_H
+#define STAGE_H
+
+#include <stdbool.h> // Include Standard Boolean Library for boolean variables
+
+#include "device.h" // device_ticks
+
+// One step of the frame loop (input, update, render) with a time budget. A stage that
+// can stop part way checks stage_over between jobs and leaves the rest for the next
+// frame; one that cannot only gets its overruns counted. Times are in device_ticks.
+
+typedef struct {
+	unsigned int budget; // Ticks the stage may take per frame
+	unsigned int start; // When the current run started
+	unsigned int runs; // Times the stage has run
+	unsigned int overruns; // Runs that took longer than budget
+	unsigned int worst; // Longest run
+	unsigned long long total; // All runs together
+} Stage;
+
+static inline void stage_init(Stage *stage, unsigned int budgetUs) {
+	stage->budget = budgetUs * device_ticks_per_us();
+	stage->runs = 0;
+	stage->overruns = 0;
+	stage->worst = 0;
+	stage->total = 0;
+}
+
+static inline void stage_begin(Stage *stage) {
+	stage->start = device_ticks();
+}
+
+// True once the stage has used up its budget for this frame
+static inline bool stage_over(const Stage *stage) {
+	return device_ticks() - stage->start >= stage->budget;
+}
+
+static inline void stage_end(Stage *stage) {
+	unsigned int elapsed = device_ticks() - stage->start;
+	stage->runs++;
+	stage->total += elapsed;
+	if (elapsed > stage->budget){
+		stage->overruns++;
+	}
+	if (elapsed > stage->worst){
+		stage->worst = elapsed;
+	}
+}
+
+#endif
@@ -0,0 +1,270 @@
+#include <fcntl.h> // Include File Control for open
+#include <string.h> // Include String Library for memcmp and memset
+#include <unistd.h> // Include POSIX Library for close
+#include <sys/mman.h> // Include Memory Mapping for mmap
+#include <sys/stat.h> // Include File Status for the file size
+
+#include "tablebase.h"
+
+bool tablebase_geometry_init(TablebaseGeometry *geometry, int rows, int cols, int k) {
+	static const int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+	MnkBoard board;
+	int n, i, s, row, col, image, byte, d, step;
+	uint32_t line;
+
+	// mnk_init checks the shape the same way the other m,n,k tools do
+	if (!mnk_init(&board, rows, cols, k) || board.cells > TABLEBASE_MAX_CELLS){
+		return false;
+	}
+	memset(geometry, 0, sizeof(*geometry));
+	geometry->rows = rows;
+	geometry->cols = cols;
+	geometry->k = k;
+	geometry->cells = board.cells;
+
+	for (n = 0; n <= geometry->cells; n++){
+		geometry->binomial[n][0] = 1;
+		for (i = 1; i <= n; i++){
+			geometry->binomial[n][i] = geometry->binomial[n - 1][i - 1] + (i < n ? geometry->binomial[n - 1][i] : 0);
+		}
+	}
+	// X moves first, so after n stones X has the extra one
+	for (n = 0; n <= geometry->cells; n++){
+		geometry->nx[n] = (n + 1) / 2;
+		geometry->layerStart[n + 1] = geometry->layerStart[n]
+			+ (uint64_t)geometry->binomial[geometry->cells][n] * geometry->binomial[n][geometry->nx[n]];
+	}
+
+	// Rotations and reflections that keep the board's shape
+	geometry->symmetries = rows == cols ? 8 : 4;
+	for (s = 0; s < geometry->symmetries; s++){
+		for (i = 0; i < geometry->cells; i++){
+			row = i / cols;
+			col = i % cols;
+			if (s & 4){
+				n = row; // Transpose, square boards only
+				row = col;
+				col = n;
+			}
+			if (s & 1){
+				col = cols - 1 - col;
+			}
+			if (s & 2){
+				row = rows - 1 - row;
+			}
+			image = row * cols + col;
+			for (byte = 0; byte < 256; byte++){
+				if ((byte >> (i & 7)) & 1){
+					geometry->symmetry[s][i >> 3][byte] |= (uint32_t)1 << image;
+				}
+			}
+		}
+	}
+
+	// Every run of k squares in a row, a column or a diagonal, like winMasks on 3x3
+	for (i = 0; i < geometry->cells; i++){
+		for (d = 0; d < 4; d++){
+			line = 0;
+			for (step = 0; step < k; step++){
+				row = i / cols + directions[d][0] * step;
+				col = i % cols + directions[d][1] * step;
+				if (row < 0 || row >= rows || col < 0 || col >= cols){
+					break;
+				}
+				line |= (uint32_t)1 << (row * cols + col);
+			}
+			if (step == k){
+				geometry->lines[geometry->lineCount++] = line;
+			}
+		}
+	}
+	return true;
+}
+
+// Sets of the same size in increasing order as numbers are in colex order, whose rank is
+// the sum of C(square, i) over the i-th lowest square
+uint64_t tablebase_number(const TablebaseGeometry *geometry, uint32_t x, uint32_t o) {
+	uint32_t occupied = x | o, bits;
+	uint64_t occupiedRank = 0, xRank = 0;
+	int n = __builtin_popcount(occupied), slot = 0, xSeen = 0, cell;
+
+	for (bits = occupied; bits; bits &= bits - 1, slot++){
+		cell = __builtin_ctz(bits);
+		occupiedRank += geometry->binomial[cell][slot + 1];
+		if ((x >> cell) & 1){
+			xSeen++;
+			xRank += geometry->binomial[slot][xSeen];
+		}
+	}
+	return geometry->layerStart[n] + occupiedRank * geometry->binomial[n][geometry->nx[n]] + xRank;
+}
+
+static inline uint32_t apply_symmetry(const TablebaseGeometry *geometry, int s, uint32_t mask) {
+	return geometry->symmetry[s][0][mask & 0xFF] | geometry->symmetry[s][1][(mask >> 8) & 0xFF]
+		| geometry->symmetry[s][2][(mask >> 16) & 0xFF];
+}
+
+void tablebase_canonical(const TablebaseGeometry *geometry, uint32_t *x, uint32_t *o) {
+	uint64_t best = (uint64_t)*x << 32 | *o, key;
+	int s;
+	for (s = 1; s < geometry->symmetries; s++){
+		key = (uint64_t)apply_symmetry(geometry, s, *x) << 32 | apply_symmetry(geometry, s, *o);
+		if (key < best){
+			best = key;
+		}
+	}
+	*x = best >> 32;
+	*o = (uint32_t)best;
+}
+
+bool tablebase_has_line(const TablebaseGeometry *geometry, uint32_t stones) {
+	int i;
+	for (i = 0; i < geometry->lineCount; i++){
+		if ((stones & geometry->lines[i]) == geometry->lines[i]){
+			return true;
+		}
+	}
+	return false;
+}
+
+void tablebase_from_mnk(const MnkBoard *board, uint32_t *x, uint32_t *o) {
+	int row, col, move;
+	*x = 0;
+	*o = 0;
+	for (row = 0; row < board->rows; row++){
+		for (col = 0; col < board->cols; col++){
+			move = mnk_move(board, row, col);
+			if (mnk_bit(&board->stones[0], move)){
+				*x |= (uint32_t)1 << (row * board->cols + col);
+			} else if (mnk_bit(&board->stones[1], move)){
+				*o |= (uint32_t)1 << (row * board->cols + col);
+			}
+		}
+	}
+}
+
+static bool section_fits(const TablebaseHeader *header, uint64_t offset, uint64_t length) {
+	return offset % 64 == 0 && offset <= header->size && length <= header->size - offset;
+}
+
+bool tablebase_open(Tablebase *tablebase, const char *path) {
+	const TablebaseHeader *header;
+	struct stat status;
+	void *mapping;
+	int fd = open(path, O_RDONLY);
+
+	memset(tablebase, 0, sizeof(*tablebase));
+	if (fd < 0){
+		return false;
+	}
+	if (fstat(fd, &status) < 0 || (size_t)status.st_size < sizeof(TablebaseHeader)){
+		close(fd);
+		return false;
+	}
+	mapping = mmap(NULL, status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd); // The mapping keeps the file
+	if (mapping == MAP_FAILED){
+		return false;
+	}
+
+	// Only the header is checked, the sections are used where they lie
+	header = mapping;
+	if (memcmp(header->magic, "TTTB", 4) != 0 || header->version != TABLEBASE_VERSION
+		|| header->size != (uint64_t)status.st_size
+		|| !tablebase_geometry_init(&tablebase->geometry, header->rows, header->cols, header->k)
+		|| header->positions != tablebase->geometry.layerStart[tablebase->geometry.cells + 1]
+		|| !section_fits(header, header->bitmapOffset, (header->positions + 63) / 64 * 8)
+		|| !section_fits(header, header->ranksOffset, (header->positions / TABLEBASE_RANK_BITS + 1) * 4)
+		|| !section_fits(header, header->valuesOffset, (header->kept + 3) / 4)
+		|| (header->hasDistances && !section_fits(header, header->distancesOffset, header->kept))){
+		munmap(mapping, status.st_size);
+		return false;
+	}
+	tablebase->header = header;
+	tablebase->size = status.st_size;
+	tablebase->bitmap = (const uint64_t *)((const char *)mapping + header->bitmapOffset);
+	tablebase->ranks = (const uint32_t *)((const char *)mapping + header->ranksOffset);
+	tablebase->values = (const uint8_t *)mapping + header->valuesOffset;
+	tablebase->distances = header->hasDistances ? (const uint8_t *)mapping + header->distancesOffset : NULL;
+	return true;
+}
+
+void tablebase_close(Tablebase *tablebase) {
+	if (tablebase->header){
+		munmap((void *)tablebase->header, tablebase->size);
+	}
+	memset(tablebase, 0, sizeof(*tablebase));
+}
+
+// Where the position's value is stored, -1 if it is not in the table
+static int64_t find(const Tablebase *tablebase, uint32_t x, uint32_t o) {
+	const TablebaseGeometry *geometry = &tablebase->geometry;
+	uint32_t full = ((uint32_t)1 << geometry->cells) - 1;
+	uint64_t number, word;
+	int n = __builtin_popcount(x | o), w, first;
+	int64_t rank;
+
+	if ((x & o) || ((x | o) & ~full) || __builtin_popcount(x) != geometry->nx[n]){
+		return -1;
+	}
+	tablebase_canonical(geometry, &x, &o);
+	number = tablebase_number(geometry, x, o);
+	word = tablebase->bitmap[number >> 6];
+	if (!((word >> (number & 63)) & 1)){
+		return -1;
+	}
+
+	// Bits before it: the rank entry of its 512-bit block, then the words before it in the block
+	rank = tablebase->ranks[number / TABLEBASE_RANK_BITS];
+	first = (number / TABLEBASE_RANK_BITS) * (TABLEBASE_RANK_BITS / 64);
+	for (w = first; w < (int)(number >> 6); w++){
+		rank += __builtin_popcountll(tablebase->bitmap[w]);
+	}
+	rank += __builtin_popcountll(word & (((uint64_t)1 << (number & 63)) - 1));
+	// The ranks come from the file, a corrupt one must not send the value reads past its sections
+	return (uint64_t)rank < tablebase->header->kept ? rank : -1;
+}
+
+int tablebase_value(const Tablebase *tablebase, uint32_t x, uint32_t o) {
+	int64_t rank = find(tablebase, x, o);
+	if (rank < 0){
+		return TABLEBASE_UNKNOWN;
+	}
+	return (tablebase->values[rank >> 2] >> ((rank & 3) * 2)) & 3;
+}
+
+int tablebase_distance(const Tablebase *tablebase, uint32_t x, uint32_t o) {
+	int64_t rank = tablebase->distances ? find(tablebase, x, o) : -1;
+	return rank < 0 ? -1 : tablebase->distances[rank];
+}
+
+// Wins as fast as it can, draws if it cannot win, and loses as slowly as it can
+int tablebase_best_move(const Tablebase *tablebase, uint32_t x, uint32_t o) {
+	const TablebaseGeometry *geometry = &tablebase->geometry;
+	int xToMove = __builtin_popcount(x | o) % 2 == 0;
+	int cell, value, distance, score, bestScore = -1, best = -1;
+	uint32_t childX, childO;
+
+	for (cell = 0; cell < geometry->cells; cell++){
+		if (((x | o) >> cell) & 1){
+			continue;
+		}
+		childX = xToMove ? x | (uint32_t)1 << cell : x;
+		childO = xToMove ? o : o | (uint32_t)1 << cell;
+		if (tablebase_has_line(geometry, xToMove ? childX : childO)){
+			return cell; // Wins on the spot
+		}
+		value = tablebase_value(tablebase, childX, childO);
+		if (value == TABLEBASE_UNKNOWN){
+			continue;
+		}
+		distance = tablebase->distances ? tablebase_distance(tablebase, childX, childO) : 0;
+		// The child's value is the opponent's: their loss is our win
+		score = (TABLEBASE_WIN - value) * 256 + (value == TABLEBASE_LOSS ? 255 - distance : distance);
+		if (score > bestScore){
+			bestScore = score;
+			best = cell;
+		}
+	}
+	return best;
+}
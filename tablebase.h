@@ -0,0 +1,84 @@
+#ifndef TABLEBASE_H
+#define TABLEBASE_H
+
+#include <stdbool.h> // Include Standard Boolean Library for boolean variables
+#include <stddef.h> // Include Standard Definitions for size_t
+#include <stdint.h> // Include fixed width integer types for the file layout
+
+#include "mnk.h" // m,n,k variant engine
+
+// Endgame tablebase for small m,n,k boards: win, draw or loss for every position that can
+// come up in a game, and optionally the plies left until the game ends with best play.
+// tools/gen_tablebase.c builds it by retrograde analysis; here it is mapped into memory
+// and read in place, so opening costs nothing and a lookup is a few table reads.
+//
+// Positions are two cell masks, bit row * cols + col for X and for O (GameBoard on the
+// 3x3 board). They are numbered densely: first by stone count, then by the rank of the
+// occupied squares among all sets of that size, then by the rank of X's squares among the
+// occupied ones. Only one position of every group of rotations and reflections is kept:
+// the one whose (x << 32 | o) is smallest.
+//
+// File layout, every section 64-byte aligned, numbers in the byte order of the machine:
+//   TablebaseHeader
+//   bitmap: one bit per position number, set when the position is kept
+//   ranks: for every 512 bits of the bitmap, how many bits are set before them (4 bytes)
+//   values: TABLEBASE_LOSS/DRAW/WIN of each kept position, 2 bits, in position order
+//   distances: plies to the end of each kept position, 1 byte (optional)
+
+#define TABLEBASE_VERSION 1
+#define TABLEBASE_MAX_CELLS 20 // 4x5 needs 741 million position numbers, anything bigger will not fit in memory
+#define TABLEBASE_RANK_BITS 512 // Bitmap bits per rank entry
+
+// Values, for the player to move
+#define TABLEBASE_LOSS 0
+#define TABLEBASE_DRAW 1
+#define TABLEBASE_WIN 2
+#define TABLEBASE_UNKNOWN 3 // Not in the table: the position cannot come up in a game
+
+typedef struct {
+	char magic[4]; // "TTTB"
+	uint8_t version;
+	uint8_t rows, cols, k;
+	uint8_t hasDistances; // 1 if the distances section is there
+	uint8_t reserved[7];
+	uint64_t positions; // Position numbers, bits in the bitmap
+	uint64_t kept; // Positions with a value
+	uint64_t bitmapOffset, ranksOffset, valuesOffset, distancesOffset; // From the start of the file
+	uint64_t size; // Whole file
+} TablebaseHeader;
+
+// What the numbering and the symmetries need for one board size, shared with the generator
+typedef struct {
+	int rows, cols, k, cells;
+	int nx[TABLEBASE_MAX_CELLS + 1]; // X's stones when n are on the board
+	uint64_t layerStart[TABLEBASE_MAX_CELLS + 2]; // First position number with n stones
+	uint32_t binomial[TABLEBASE_MAX_CELLS + 1][TABLEBASE_MAX_CELLS + 1];
+	int symmetries; // 8 on square boards, 4 otherwise
+	uint32_t symmetry[8][3][256]; // Image of every byte of a cell mask under each symmetry
+	int lineCount;
+	uint32_t lines[4 * TABLEBASE_MAX_CELLS]; // Every k in a row, as a cell mask
+} TablebaseGeometry;
+
+typedef struct {
+	const TablebaseHeader *header; // Start of the mapping
+	size_t size;
+	const uint64_t *bitmap;
+	const uint32_t *ranks;
+	const uint8_t *values;
+	const uint8_t *distances; // NULL without the distances section
+	TablebaseGeometry geometry;
+} Tablebase;
+
+bool tablebase_geometry_init(TablebaseGeometry *geometry, int rows, int cols, int k); // False if the board is unsupported
+uint64_t tablebase_number(const TablebaseGeometry *geometry, uint32_t x, uint32_t o); // Position number, the stone counts must be legal
+void tablebase_canonical(const TablebaseGeometry *geometry, uint32_t *x, uint32_t *o); // Smallest of the position's symmetric copies
+bool tablebase_has_line(const TablebaseGeometry *geometry, uint32_t stones); // True if stones hold k in a row
+void tablebase_from_mnk(const MnkBoard *board, uint32_t *x, uint32_t *o); // Cell masks of an MnkBoard
+
+bool tablebase_open(Tablebase *tablebase, const char *path);
+void tablebase_close(Tablebase *tablebase);
+int tablebase_value(const Tablebase *tablebase, uint32_t x, uint32_t o); // TABLEBASE_* for the player to move
+int tablebase_distance(const Tablebase *tablebase, uint32_t x, uint32_t o); // Plies to the end, -1 if unknown or not in the file
+int tablebase_best_move(const Tablebase *tablebase, uint32_t x, uint32_t o); // Square (row * cols + col), -1 if there is none
+
+#endif
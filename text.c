@@ -0,0 +1,73 @@
+#include <string.h> // Include String Library for memcpy and memset
+
+#include "device.h" // Character buffer address and size
+#include "text.h"
+
+#define SPACES 0x20202020u // Four blank characters
+
+typedef uint32_t __attribute__((may_alias)) TextWord; // Four characters compared or stored at once
+
+static char target[CHAR_ROWS][CHAR_COLUMNS] __attribute__((aligned(4))); // What the screen should show
+static char shadow[CHAR_ROWS][CHAR_COLUMNS] __attribute__((aligned(4))); // What the character buffer holds
+static uint64_t usedRows = 0; // Rows of target with something written since the last clear
+static uint64_t dirtyRows = 0; // Rows of target that may differ from shadow
+
+void text_init(void) {
+	volatile TextWord *row;
+	int x, y;
+	for (y = 0; y < CHAR_ROWS; y++){
+		row = (volatile TextWord *)(device_char_buffer() + (y << 7));
+		for (x = 0; x < CHAR_COLUMNS / 4; x++){
+			row[x] = SPACES;
+		}
+	}
+	memset(target, ' ', sizeof(target));
+	memset(shadow, ' ', sizeof(shadow));
+	usedRows = 0;
+	dirtyRows = 0;
+}
+
+void text_write(int x, int y, const char *text) {
+	int length = strlen(text);
+	if (y < 0 || y >= CHAR_ROWS || x < 0 || x >= CHAR_COLUMNS){
+		return;
+	}
+	if (length > CHAR_COLUMNS - x){
+		length = CHAR_COLUMNS - x;
+	}
+	memcpy(&target[y][x], text, length);
+	usedRows |= 1ULL << y;
+	dirtyRows |= 1ULL << y;
+}
+
+void text_clear(void) {
+	uint64_t rows;
+	for (rows = usedRows; rows; rows &= rows - 1){
+		memset(target[__builtin_ctzll(rows)], ' ', CHAR_COLUMNS);
+	}
+	dirtyRows |= usedRows;
+	usedRows = 0;
+}
+
+int text_flush(void) {
+	volatile TextWord *buffer;
+	TextWord *want, *have;
+	uint64_t rows;
+	int x, y, written = 0;
+
+	for (rows = dirtyRows; rows; rows &= rows - 1){
+		y = __builtin_ctzll(rows);
+		want = (TextWord *)target[y];
+		have = (TextWord *)shadow[y];
+		buffer = (volatile TextWord *)(device_char_buffer() + (y << 7));
+		for (x = 0; x < CHAR_COLUMNS / 4; x++){
+			if (want[x] != have[x]){
+				buffer[x] = want[x];
+				have[x] = want[x];
+				written += 4;
+			}
+		}
+	}
+	dirtyRows = 0;
+	return written;
+}
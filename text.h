@@ -0,0 +1,15 @@
+#ifndef TEXT_H
+#define TEXT_H
+
+// Text layer for the 80x60 character buffer. Writes and clears go to a copy in RAM;
+// text_flush compares it four characters at a time with a shadow of what the character
+// buffer already holds and only stores the words that differ. Rewriting a line with
+// the same text, or switching back and forth between two screens, touches nothing
+// that stayed the same.
+
+void text_init(void); // Fills the character buffer with spaces, must come before anything else
+void text_write(int x, int y, const char *text); // Puts text at column x, row y, cut off at the right edge
+void text_clear(void); // Blanks every row that has text on it
+int text_flush(void); // Copies what changed into the character buffer, returns characters written
+
+#endif
@@ -1,909 +1,784 @@
 
 #include <stdbool.h> // Include Standard Boolean Library for boolean variables
 #include <stdio.h> // Include Standard Input Output Library for basic I/O operations
+#include <stdlib.h> // Include Standard Library for abs
+#include <string.h> // Include String Library for memset and strlen
+
+#include "device.h" // Board or host backend for video, PS/2 and interrupts
+#include "game.h" // Bitboard game core
+#include "ai.h" // Perfect-play computer opponent
+#include "dirty.h" // Dirty rectangle tracking
+#include "raster.h" // Wide span and rectangle fills
+#include "sprite.h" // Pre-rendered X and O
+#include "text.h" // Character buffer with change tracking
+#include "ring.h" // Lock-free scancode queue
+#include "keyboard.h" // Scancode decoder
+#include "stage.h" // Time budgets for the frame loop
+#include "profile.h" // Cycle histograms
+#include "trace.h" // Input recording
+#include "session.h" // Game state
 
 
-// Function prototypes for configuring and handling interrupts
-void disableInterrupts(void);// Disables interrupts in the ARM A9 processor
-void setIRQStack(void);// Sets up the stack for IRQ mode
-void configureGIC(void);// Configures the General Interrupt Controller (GIC)
-void configureKEYs(void);// Configures the FPGA's PS/2 port for keygameBoard interrupts
-void enable_A9_interrupts(void);// Enables interrupts in the ARM A9 processor
-void keygameBoard_ISR(void);// Interrupt Service Routine for keygameBoard interrupts
-void configureinterrupt(int, int);// Configures individual interrupts
-
 // Function prototypes for rendering and game logic
-void render_player(int gameBoardIndex);
-void render_player_X(int gameBoardIndex);
-void render_player_O(int gameBoardIndex);
+void render_piece(int gameBoardIndex, const Sprite *sprite); // Blits a piece into a box (1-9)
 void initial_screen();// Sets up the initial game screen
-void draw_pixel(int x, int y, short int line_color); // Draws a single pixel on the screen
-void render_line(int x0, int y0, int x1, int y1, short int line_color);// Renders a line on the screen
+void start_screen();// Renders the title screen
 void render_selection_box(int x, int y, short int selection_colour);// Renders a selection box on the screen
-void swap(int *first, int *second);// Swaps two integers
 void render_gameBoard(void);// Renders the tic-tac-toe gameBoard
-void display_text(int x, int y, char * text_ptr);// Writes text to the screen
-void delete_screen(); // Clears the graphical screen
-
-
-
+void display_board_text(void);// Writes the labels and hints around the gameBoard
+void display_text(int x, int y, const char * text_ptr);// Writes text to the screen
+void fill_rect(int x0, int y0, int x1, int y1, short int colour); // Fills a rectangle (inclusive corners)
+void repaint_rect(int x0, int y0, int x1, int y1); // Redraws part of the current view into the back buffer
+void present_frame(void); // Redraws the dirty rectangles and shows them
+void set_view(int newView); // Switches between title, gameBoard and text screens
+void mark_cell(int gameBoardIndex); // Marks a box (1-9) as needing a redraw
+void mark_selection_box(void); // Marks the outline of the selection box as needing a redraw
+void move_selection(int cell); // Moves the selection box to a box (0-8) and shows it
+void mark_strike(int line); // Marks a strike-through as needing a redraw
+void mark_view(int shownView); // Marks everything a view draws as needing a redraw
+int decode_key(unsigned char byte0); // Decodes one scancode byte, returns the action of a finished key press
+void apply_action(int action); // Applies one key press to the game
+void input_stage(void); // Turns queued scancodes into queued actions
+void update_stage(void); // Applies queued actions and the computer's moves
+void render_stage(void); // Shows what changed
+void print_stage(const char *name, const Stage *stage); // Prints how long a stage took
+
+
+
+
+// Screens the game can show, repaint_rect rebuilds any part of them from the game state
+#define VIEW_TITLE 0 // Blue title screen
+#define VIEW_GAME 1 // gameBoard with pieces, strike and selection box
+#define VIEW_TEXT 2 // Black screen with text only (help, score board)
+
+// What a key press does, see keyActions
+enum {
+	ACTION_NONE,
+	ACTION_UP, ACTION_DOWN, ACTION_LEFT, ACTION_RIGHT, // Repeat while the key is held
+	ACTION_START, ACTION_RESTART, ACTION_COMPUTER, ACTION_SCOREBOARD, ACTION_HELP, ACTION_RESUME, ACTION_PLACE,
+	ACTION_PROFILE,
+	ACTION_SELECT_1, ACTION_SELECT_2, ACTION_SELECT_3, ACTION_SELECT_4, ACTION_SELECT_5,
+	ACTION_SELECT_6, ACTION_SELECT_7, ACTION_SELECT_8, ACTION_SELECT_9
+};
 
 // Functions which handle the tic-tac-toe logic
-int check_winner(); // Checks for a winner in the game
+int check_winner(int *line); // Checks for a winner in the game and which line won
+int place_piece(int gameBoardIndex); // Places the current player's piece and checks the result
+void computer_move(void); // Lets the computer take its turn
+void render_strike(int line); // Strikes through a winning line
 void delete_text (); // Clears any text from the screen
-void checkforDraw();  // Checks for a Draw condition in the game
 
 // Global variables
-int selX; // X position of the selection box
-int selY; // Y position of the selection box
-int xScore = 0; // Score of player X
-int OScore = 0; // Score of player O
-int totalMatchesPlayed = 0; // Total number of matches played
-char scoreStr[10];
-bool isDraw = false; // Flag for Draw condition
-char Turn; // Indicates whose turn it is ('X' or 'O')
-int gameBoard[9]; 
-volatile int framebufferStart; // global variable, to render 
+Session session; // The game on screen: board, turn, selected box, scores and single player mode
+char scoreStr[12];
+volatile uintptr_t framebufferStart; // global variable, to render (always the back buffer)
+int view = VIEW_TITLE; // Which screen is showing
+bool selectionVisible = false; // The selection box is hidden once a game ends
+RasterRect clip = {0, 0, SCREEN_WIDTH - 1, SCREEN_HEIGHT - 1}; // Drawing only writes inside
+unsigned int pixelWrites = 0; // Pixels drawn for the current key
+unsigned int pixelCopies = 0; // Pixels copied into the new back buffer for the current key
+unsigned int keyCount = 0; // Keys handled so far
+unsigned int keyWritesWorst = 0; // Most pixels written for one key
+unsigned long long keyWritesTotal = 0, keyCopiesTotal = 0;
+unsigned int textWrites = 0; // Characters stored into the character buffer for the current key
+unsigned long long keyTextTotal = 0;
+ByteRing scancodes; // Filled by keygameBoard_ISR, drained by the input stage
+ByteRing actions; // Filled by the input stage, drained by the update stage
+Keyboard keyboard; // Scancode decoder state
+bool computerPending = false; // The computer still has to answer, done by the update stage
+Stage inputStage, updateStage, renderStage;
+unsigned int ticksMissed = 0; // Frame ticks that went by while a frame was still being worked on
+unsigned int isrCount = 0; // Interrupts taken
+unsigned int isrTicksWorst = 0; // Longest ISR in device_ticks
+unsigned long long isrTicksTotal = 0;
+unsigned int fifoHighWater = 0; // Most bytes seen waiting in the PS/2 FIFO
+volatile unsigned int keyCycles; // device_cycles of the last PS/2 interrupt
+unsigned int latencyStart; // keyCycles of the oldest key press not shown yet
+bool latencyPending = false;
+
+// What each key does, indexed by [extended][make code], other keys do nothing
+const unsigned char keyActions[2][256] = {
+	{
+		[0x22] = ACTION_START, // X
+		[0x1D] = ACTION_UP, [0x1B] = ACTION_DOWN, [0x1C] = ACTION_LEFT, [0x23] = ACTION_RIGHT, // W S A D
+		[0x29] = ACTION_RESTART, // Space
+		[0x21] = ACTION_COMPUTER, // C
+		[0x32] = ACTION_SCOREBOARD, // B
+		[0x16] = ACTION_SELECT_1, [0x1E] = ACTION_SELECT_2, [0x26] = ACTION_SELECT_3, // 1 2 3
+		[0x25] = ACTION_SELECT_4, [0x2E] = ACTION_SELECT_5, [0x36] = ACTION_SELECT_6, // 4 5 6
+		[0x3D] = ACTION_SELECT_7, [0x3E] = ACTION_SELECT_8, [0x46] = ACTION_SELECT_9, // 7 8 9
+		[0x33] = ACTION_HELP, // H
+		[0x76] = ACTION_RESUME, // Escape
+		[0x5A] = ACTION_PLACE, // Enter
+		[0x4D] = ACTION_PROFILE // P
+	},
+	{
+		[0x75] = ACTION_UP, [0x72] = ACTION_DOWN, [0x6B] = ACTION_LEFT, [0x74] = ACTION_RIGHT, // Arrow keys
+		[0x5A] = ACTION_PLACE // Keypad Enter
+	}
+};
+
+// Status line texts, padded to blank out a longer message
+const char statusTurnX[] = "                    Player X's Turn!                      ";
+const char statusTurnO[] = "                    Player O's Turn!                      ";
+
+// Top left corner of every gameBoard box, the selection box sits on it and pieces are blitted to it
+const short cellOrigin[BOARD_CELLS][2] = {
+	{25, 25}, {115, 25}, {205, 25},
+	{25, 88}, {115, 88}, {205, 88},
+	{25, 151}, {115, 151}, {205, 151}
+};
+
+// The glyphs relative to their box, rendered into sprites once at start-up
+const RasterSegment xSegments[2] = {
+	{4, 4, 86, 59}, {86, 4, 4, 59} // Left and right diagonal
+};
+const RasterSegment oSegments[8] = {
+	{73, 2, 17, 2}, {17, 2, 5, 6}, {5, 6, 5, 57}, {5, 57, 17, 61},
+	{17, 61, 73, 61}, {73, 61, 85, 57}, {85, 57, 85, 6}, {85, 6, 73, 2}
+};
+Sprite spriteX, spriteO;
+
+// Centre lines of the 3 pixel wide strike-throughs, in winMasks order
+const RasterSegment strikeSegments[8] = {
+	{70, 25, 70, 214}, {160, 25, 160, 214}, {250, 25, 250, 214}, // Columns
+	{25, 56, 295, 56}, {25, 119, 295, 119}, {25, 182, 295, 182}, // Rows
+	{25, 25, 295, 214}, {295, 25, 25, 214} // Left and right diagonal
+};
+
+// Time budgets in microseconds, a frame is 1000000 / FRAME_RATE. Input always runs first and
+// the update stage stops between jobs, so a slow move can only delay the frame after it.
+#define INPUT_BUDGET_US 1000
+#define UPDATE_BUDGET_US 4000
+#define RENDER_BUDGET_US 10000
+
+unsigned int frameStartTicks; // When the current frame started
+unsigned int frameCount = 0; // Frames shown so far
+unsigned int frameTimeLast = 0, frameTimeWorst = 0; // Frame time in microseconds, all three stages
+unsigned long long frameTimeTotal = 0;
 
 int main(void) {
-	delete_text();
+	device_init();
+	text_init();
+	keyboard_init(&keyboard);
 	
-	// First turn goes to X
-	Turn = 'X';
+	// First turn goes to X, the red selection box starts on the top left box
+	session_init(&session, false);
 	
-	// This is the top left corner of the first box
-	// Red selection box starts here initially
-	selX = 25;
-	selY = 25;
+	/* Everything is drawn into the back buffer and shown by present_frame */
+	framebufferStart = device_back_buffer();
 	
-	volatile int * pixel_ctrl_ptr = (int *)0xFF203020;
-    
-	/* Read location of the pixel buffer from the pixel buffer controller */
-    framebufferStart = *pixel_ctrl_ptr;
+	sprite_build(&spriteX, xSegments, 2, 1);
+	sprite_build(&spriteO, oSegments, 8, 1);
 	
-	delete_screen();
-	start_screen();
+	stage_init(&inputStage, INPUT_BUDGET_US);
+	stage_init(&updateStage, UPDATE_BUDGET_US);
+	stage_init(&renderStage, RENDER_BUDGET_US);
 	
-	disableInterrupts(); // disable interrupts in the A9 processor
-	setIRQStack(); // initialize the stack pointer for IRQ mode
-	configureGIC(); // configure the general interrupt controller
-	configureKEYs(); // configure pushbutton KEYs to generate interrupts
-	enable_A9_interrupts(); // enable interrupts in the A9 processor
-	
-	while (1); // wait for an interrupt
-}
-
-
-/* setup the PS/2 interrupts in the FPGA */
-void configureKEYs() {
-	volatile int * PS2_ptr = (int *) 0xFF200100; // PS/2 base address
-	*(PS2_ptr + 1) = 0x00000001; // set RE to 1 to enable interrupts
+	frameStartTicks = device_ticks();
+	dirty_add(0, 0, SCREEN_WIDTH - 1, SCREEN_HEIGHT - 1);
+	start_screen();
+	text_flush();
+	present_frame();
+	
+	trace_start();
+	device_configure_interrupts(); // route PS/2 interrupts to keygameBoard_ISR
+	
+	// The ISR only queues scancodes, all game and drawing work happens here. Sleep until an
+	// interrupt, decode new keys right away and update and redraw once per frame tick.
+	unsigned int tick = device_frame_ticks(), now;
+	bool more;
+	do {
+		more = device_idle();
+		input_stage();
+		now = device_frame_ticks();
+		if (now != tick){
+			ticksMissed += now - tick - 1;
+			tick = now;
+			frameStartTicks = device_ticks();
+			update_stage();
+			render_stage();
+		}
+	} while (more || ring_count(&scancodes) > 0 || ring_count(&actions) > 0 || computerPending);
+	
+	// Only reached on the host, where input runs out
+	if (frameCount > 0){
+		printf("%u frames, frame time average %llu us, worst %u us\n",
+			frameCount, frameTimeTotal / frameCount, frameTimeWorst);
+		printf("%u keys, pixels written per frame average %llu, worst %u, pixels copied per frame average %llu\n",
+			keyCount, keyWritesTotal / frameCount, keyWritesWorst, keyCopiesTotal / frameCount);
+		printf("characters written per frame average %llu\n", keyTextTotal / frameCount);
+	}
+	print_stage("input", &inputStage);
+	print_stage("update", &updateStage);
+	print_stage("render", &renderStage);
+	printf("%u frame ticks missed\n", ticksMissed);
+	profile_dump();
+	if (isrCount > 0){
+		printf("%u interrupts, ISR time average %llu ns, worst %llu ns, PS/2 FIFO high water %u, dropped bytes %u\n",
+			isrCount, isrTicksTotal * 1000 / device_ticks_per_us() / isrCount,
+			isrTicksWorst * 1000ULL / device_ticks_per_us(), fifoHighWater, scancodes.dropped);
+	}
+	return device_exit(session.xScore, session.OScore, session.totalMatchesPlayed);
 }
 
-// Define the IRQ exception handler
-void __attribute__((interrupt)) __cs3_isr_irq(void) {
-	// Read the ICCIAR from the CPU Interface in the GIC
-	int interrupt_ID = *((int *)0xFFFEC10C);
-	if (interrupt_ID == 79) // check if interrupt is from the KEYs
-	keygameBoard_ISR();
-	else
-	while (1); // if unexpected, then stay here
-	// Write to the End of Interrupt Register (ICCEOIR)
-	*((int *)0xFFFEC110) = interrupt_ID;
+void fill_rect(int x0, int y0, int x1, int y1, short int colour){
+	if (x0 < clip.x0) x0 = clip.x0;
+	if (y0 < clip.y0) y0 = clip.y0;
+	if (x1 > clip.x1) x1 = clip.x1;
+	if (y1 > clip.y1) y1 = clip.y1;
+	if (x0 > x1 || y0 > y1){
+		return;
+	}
+	raster_rect(framebufferStart, x0, y0, x1, y1, colour);
+	pixelWrites += (x1 - x0 + 1) * (y1 - y0 + 1);
 }
 
-// Define the remaining exception handlers
-void __attribute__((interrupt)) __cs3_reset(void) {
-	while (1);
+// Redraws one rectangle of the back buffer from the game state, nothing outside it is touched
+void repaint_rect(int x0, int y0, int x1, int y1){
+	clip.x0 = x0;
+	clip.y0 = y0;
+	clip.x1 = x1;
+	clip.y1 = y1;
+	
+	if (view == VIEW_TITLE){
+		fill_rect(x0, y0, x1, y1, 0x00FF);
+	} else {
+		fill_rect(x0, y0, x1, y1, 0x0000);
+	}
+	
+	if (view == VIEW_GAME){
+		render_gameBoard();
+		
+		// Walk the set bits of each player's mask, sprite_blit skips boxes outside the clip
+		unsigned short pieces;
+		for (pieces = session.board.x; pieces; pieces &= pieces - 1){
+			render_piece(__builtin_ctz(pieces) + 1, &spriteX);
+		}
+		for (pieces = session.board.o; pieces; pieces &= pieces - 1){
+			render_piece(__builtin_ctz(pieces) + 1, &spriteO);
+		}
+		
+		int line;
+		board_evaluate(session.board, &line);
+		render_strike(line);
+		
+		if (selectionVisible){
+			render_selection_box(cellOrigin[session.selection][0], cellOrigin[session.selection][1], 0xF800);
+		}
+	}
+	
+	clip.x0 = 0;
+	clip.y0 = 0;
+	clip.x1 = SCREEN_WIDTH - 1;
+	clip.y1 = SCREEN_HEIGHT - 1;
 }
 
-void __attribute__((interrupt)) __cs3_isr_undef(void) {
-	while (1);
+// Redraws the dirty rectangles, swaps the back buffer onto the screen at vertical sync, then
+// copies the same rectangles into the new back buffer so both buffers agree again
+void present_frame(void){
+	const DirtyRect *rects = dirty_rects();
+	int count = dirty_count();
+	int i, y;
+	if (count == 0){
+		return;
+	}
+	for (i = 0; i < count; i++){
+		unsigned int start = profile_begin();
+		repaint_rect(rects[i].x0, rects[i].y0, rects[i].x1, rects[i].y1);
+		profile_end(PROFILE_REPAINT, start);
+	}
+	
+	unsigned int start = profile_begin();
+	device_swap_buffers();
+	profile_end(PROFILE_SWAP, start);
+	framebufferStart = device_back_buffer();
+	
+	uintptr_t front = device_pixel_buffer();
+	for (i = 0; i < count; i++){
+		int offset = rects[i].x0 << 1, width = rects[i].x1 - rects[i].x0 + 1;
+		for (y = rects[i].y0; y <= rects[i].y1; y++){
+			memcpy((void *)(framebufferStart + (y << 10) + offset), (void *)(front + (y << 10) + offset), width * 2);
+		}
+		pixelCopies += width * (rects[i].y1 - rects[i].y0 + 1);
+	}
+	dirty_reset();
+	
+	frameTimeLast = (device_ticks() - frameStartTicks) / device_ticks_per_us();
+	frameTimeTotal += frameTimeLast;
+	if (frameTimeLast > frameTimeWorst){
+		frameTimeWorst = frameTimeLast;
+	}
+	frameCount++;
 }
 
-void __attribute__((interrupt)) __cs3_isr_swi(void) {
-	while (1);
+// Area each view draws into, black screens with only text have none
+void mark_view(int shownView){
+	if (shownView == VIEW_TITLE){
+		dirty_add(0, 0, SCREEN_WIDTH - 1, SCREEN_HEIGHT - 1);
+	} else if (shownView == VIEW_GAME){
+		dirty_add(24, 24, 296, 215);
+	}
 }
 
-void __attribute__((interrupt)) __cs3_isr_pabort(void) {
-	while (1);
+void set_view(int newView){
+	if (newView == view){
+		return;
+	}
+	mark_view(view);
+	view = newView;
+	mark_view(view);
 }
 
-void __attribute__((interrupt)) __cs3_isr_dabort(void) {
-	while (1);
+// Everything a piece in the box can cover, inside the box outline
+void mark_cell(int gameBoardIndex){
+	int x = cellOrigin[gameBoardIndex - 1][0], y = cellOrigin[gameBoardIndex - 1][1];
+	if (view == VIEW_GAME){
+		dirty_add(x, y, x + SPRITE_WIDTH - 1, y + SPRITE_HEIGHT - 1);
+	}
 }
 
-void __attribute__((interrupt)) __cs3_isr_fiq(void) {
-	while (1);
+// Only the four edges, the inside of the box does not change
+void mark_selection_box(void){
+	int selX = cellOrigin[session.selection][0], selY = cellOrigin[session.selection][1];
+	if (view == VIEW_GAME){
+		dirty_add(selX, selY, selX + 90, selY);
+		dirty_add(selX, selY + 63, selX + 90, selY + 63);
+		dirty_add(selX, selY, selX, selY + 63);
+		dirty_add(selX + 90, selY, selX + 90, selY + 63);
+	}
 }
 
-//Initialize the banked stack pointer register for IRQ mode
-void setIRQStack(void) {
-	int stack, mode;
-	stack = 0xFFFFFFFF - 7; // top of A9 onchip memory, aligned to 8 bytes
-	/* change processor to IRQ mode with interrupts disabled */
-	mode = 0b11010010;
-	asm("msr cpsr, %[ps]" : : [ps] "r"(mode));
-	/* set banked stack pointer */
-	asm("mov sp, %[ps]" : : [ps] "r"(stack));
-	/* go back to SVC mode before executing subroutine return! */
-	mode = 0b11010011;
-	asm("msr cpsr, %[ps]" : : [ps] "r"(mode));
+// Area covered by a strike-through, one pixel either side of its centre line
+void mark_strike(int line){
+	if (line == NO_LINE || view != VIEW_GAME){
+		return;
+	}
+	const RasterSegment *strike = &strikeSegments[line];
+	dirty_add((strike->x0 < strike->x1 ? strike->x0 : strike->x1) - 1, strike->y0 - 1,
+		(strike->x0 < strike->x1 ? strike->x1 : strike->x0) + 1, strike->y1 + 1);
 }
 
-/*
-* Turn on interrupts in the ARM processor
-*/
-void enable_A9_interrupts(void) {
-	int status = 0b01010011;
-	asm("msr cpsr, %[ps]" : : [ps] "r"(status));
+void move_selection(int cell){
+	if (selectionVisible){
+		mark_selection_box();
+	}
+	session.selection = cell;
+	selectionVisible = true;
+	mark_selection_box();
 }
 
-// Turn off interrupts in the ARM processor
-void disableInterrupts(void) {
-	int status = 0b11010011;
-	asm("msr cpsr, %[ps]" : : [ps] "r"(status));
+// Clear any text on the screen, only rows with text on them cost anything
+void delete_text (){
+	text_clear();
 }
 
-/*
-* Configure the Generic Interrupt Controller (GIC)
-*/
-void configureGIC(void) {
-	configureinterrupt (79, 1); // configure the FPGA KEYs interrupt (73)
-	// Set Interrupt Priority Mask Register (ICCPMR). Enable interrupts of all
-	// priorities
-	*((int *) 0xFFFEC104) = 0xFFFF;
-	// Set CPU Interface Control Register (ICCICR). Enable signaling of
-	// interrupts
-	*((int *) 0xFFFEC100) = 1;
-	// Configure the Distributor Control Register (ICDDCR) to send pending
-	// interrupts to CPUs
-	*((int *) 0xFFFED000) = 1;
+// Takes every byte waiting in the PS/2 FIFO and queues it for the main loop, nothing else.
+// Runs in IRQ mode, so it has to be short: drawing here would hold off the next byte.
+void keygameBoard_ISR(void) {
+	unsigned int start = device_ticks(), elapsed;
+	int PS2_data = device_ps2_read();
+	keyCycles = device_cycles();
+	
+	// when RVALID is 1, there is data 
+	while (PS2_data & PS2_RVALID){
+		ring_push(&scancodes, PS2_data & 0xFF); //data in LSB
+		trace_record(PS2_data & 0xFF);
+		
+		// RAVAIL: bytes still waiting in the FIFO behind this one
+		if (((unsigned int)PS2_data >> 16) > fifoHighWater){
+			fifoHighWater = (unsigned int)PS2_data >> 16;
+		}
+		PS2_data = device_ps2_read();
+	}
+	
+	//Clear Interrupt 
+	device_ps2_ack();
+	
+	elapsed = device_ticks() - start;
+	isrTicksTotal += elapsed;
+	if (elapsed > isrTicksWorst){
+		isrTicksWorst = elapsed;
+	}
+	isrCount++;
 }
 
-/*
-* Configure Set Enable Registers (ICDISERn) and Interrupt Processor Target
-* Registers (ICDIPTRn). The default (reset) values are used for other registers
-* in the GIC.
-*/
-void configureinterrupt(int N, int CPU_target) {
-	int reg_offset, index, value, address;
-	/* Configure the Interrupt Set-Enable Registers (ICDISERn).
-	* reg_offset = (integer_div(N / 32) * 4
-	* value = 1 << (N mod 32) */
-	reg_offset = (N >> 3) & 0xFFFFFFFC;
-	index = N & 0x1F;
-	value = 0x1 << index;
-	address = 0xFFFED100 + reg_offset;
-	/* Now that we know the register address and value, set the appropriate bit */
-	*(int *)address |= value;
-
-	/* Configure the Interrupt Processor Targets Register (ICDIPTRn)
-	* reg_offset = integer_div(N / 4) * 4
-	* index = N mod 4 */
-	reg_offset = (N & 0xFFFFFFFC);
-	index = N & 0x3;
-	address = 0xFFFED800 + reg_offset + index;
-	/* Now that we know the register address and value, write to (only) the
-	* appropriate byte */
-	*(char *)address = (char)CPU_target;
+// Input stage: decodes scancodes into actions until they run out, the action queue is full
+// or the budget is used up, at least one byte per run. The rest stays queued for the next wake up.
+void input_stage(void){
+	unsigned char byte;
+	int action;
+	stage_begin(&inputStage);
+	while (ring_count(&actions) < RING_SIZE && ring_pop(&scancodes, &byte)){
+		unsigned int start = profile_begin();
+		action = decode_key(byte);
+		profile_end(PROFILE_DECODE, start);
+		if (action != ACTION_NONE){
+			ring_push(&actions, action);
+			if (!latencyPending){
+				latencyStart = keyCycles;
+				latencyPending = true;
+			}
+		}
+		if (stage_over(&inputStage)){
+			break;
+		}
+	}
+	stage_end(&inputStage);
 }
 
-void draw_pixel(int x, int y, short int line_color)
-{
-    *(short int *)(framebufferStart + (y << 10) + (x << 1)) = line_color;
+// Update stage: one job at a time, the computer's answer before the next key press, until
+// nothing is left or the budget is used up. At least one job runs every frame.
+void update_stage(void){
+	unsigned char action;
+	stage_begin(&updateStage);
+	do {
+		if (computerPending){
+			computerPending = false;
+			computer_move();
+		} else if (ring_pop(&actions, &action)){
+			unsigned int start = profile_begin();
+			apply_action(action);
+			profile_end(PROFILE_ACTION, start);
+		} else {
+			break;
+		}
+	} while (!stage_over(&updateStage));
+	stage_end(&updateStage);
 }
 
-// Clear screen by writing black into the address
-void delete_screen (){
-	int y,x;
-	for(x=0;x<320;x++){
-		for(y=0;y<240;y++){
-			draw_pixel(x,y,0x0000);
-		}
+// Render stage: text and dirty rectangles, both only cost something if anything changed
+void render_stage(void){
+	stage_begin(&renderStage);
+	pixelWrites = 0;
+	pixelCopies = 0;
+	unsigned int start = profile_begin();
+	textWrites = text_flush();
+	profile_end(PROFILE_TEXT, start);
+	present_frame();
+	
+	// Key presses are on screen once none are left waiting for the update stage
+	if (latencyPending && ring_count(&actions) == 0 && !computerPending){
+		profile_end(PROFILE_LATENCY, latencyStart);
+		latencyPending = false;
+	}
+	keyWritesTotal += pixelWrites;
+	keyTextTotal += textWrites;
+	keyCopiesTotal += pixelCopies;
+	if (pixelWrites > keyWritesWorst){
+		keyWritesWorst = pixelWrites;
 	}
+	stage_end(&renderStage);
 }
 
-// Clear any text on the screen by writing " " into the address
-void delete_text (){
-	int y,x;
-	for(x=0;x<80;x++){
-		for(y=0;y<60;y++){
-			char clear[1] = " \0";
-			display_text(x, y, clear);
-		}
+void print_stage(const char *name, const Stage *stage){
+	if (stage->runs > 0){
+		printf("%s stage average %llu us, worst %u us, over budget %u of %u runs\n", name,
+			stage->total / device_ticks_per_us() / stage->runs, stage->worst / device_ticks_per_us(),
+			stage->overruns, stage->runs);
 	}
 }
 
-// Function which handles what to do once a keygameBoard interrupt is given
-void keygameBoard_ISR(void) {
-
-	volatile int * PS2_ptr = (int *)0xFF200100; // Points to PS2 Base
-	unsigned char byte0 = 0;
-    
-	int PS2_data = *(PS2_ptr);
-	int RVALID = PS2_data & 0x8000;
+// Function which decodes one byte from the keyboard, returns the action once a key press is complete
+int decode_key(unsigned char byte0) {
+	KeyEvent event;
+	int action;
 	
-	//Read Interrupt Register
-	int readInterruptReg;
-	readInterruptReg = *(PS2_ptr + 1 ); 
-	  
-	//Clear Interrupt 
-	*(PS2_ptr+1) = readInterruptReg; 
-
-	// when RVALID is 1, there is data 
-	if (RVALID != 0){         
-		byte0 = (PS2_data & 0xFF); //data in LSB	
+	// Prefix bytes and key releases change nothing on screen
+	if (!keyboard_decode(&keyboard, byte0, &event) || event.released){
+		return ACTION_NONE;
+	}
+	action = keyActions[event.extended][event.code];
 	
-		if(byte0 == 0x22){  //X, start game
-			delete_screen();
-			delete_text();
-			render_gameBoard();
-			render_selection_box(selX, selY, 0xF800);
-			isDraw = false;
-			char player_status[150] = "                    Player X's Turn!                      \0";
-			display_text(14, 55, player_status);
-		}
+	// Holding a key only keeps moving the selection box, everything else happens once per press
+	if (event.repeat && !(action >= ACTION_UP && action <= ACTION_RIGHT)){
+		return ACTION_NONE;
+	}
+	return action;
+}
+
+// Function which handles what to do with one key press, called from the update stage
+void apply_action(int action) {
+	int line, row = session.selection / 3, column = session.selection % 3;
+	unsigned short pieces;
+	
+	keyCount++;
+
+	switch (action){
+	case ACTION_START: //X, start game
+		set_view(VIEW_GAME);
+		move_selection(session.selection);
+		delete_text();
+		display_board_text();
+		display_text(14, 55, statusTurnX);
+		break;
+
+	// Moving off an edge loops back to the other side of the same row or column
+	case ACTION_UP: //UP, W
+		move_selection((row + 2) % 3 * 3 + column);
+		break;
+
+	case ACTION_DOWN: //DOWN, S
+		move_selection((row + 1) % 3 * 3 + column);
+		break;
+
+	case ACTION_LEFT: //LEFT, A
+		move_selection(row * 3 + (column + 2) % 3);
+		break;
+
+	case ACTION_RIGHT: //RIGHT, D
+		move_selection(row * 3 + (column + 1) % 3);
+		break;
+
+	case ACTION_RESTART: //SpaceBar , Restart Game
+		set_view(VIEW_GAME);
+		delete_text();
+		display_board_text();
 		
-		if(byte0 == 0x1D){  //UP, W
-			// Erase currently rendern selection box by rendering it black
-			render_selection_box(selX, selY, 0x0000);
-			render_gameBoard();
-			selY = selY - 63;
-			
-			// Loop back to the first box
-			if (selY == -38){
-				selY = 151;
-			}
-			
-			render_selection_box(selX, selY, 0xF800);
+		// Only the boxes with pieces and the strike need clearing
+		board_evaluate(session.board, &line);
+		mark_strike(line);
+		for (pieces = session.board.x | session.board.o; pieces; pieces &= pieces - 1){
+			mark_cell(__builtin_ctz(pieces) + 1);
 		}
+		
+		session_new_game(&session);
+		
+		// Reinitialize selection box to the top left box
+		move_selection(0);
+		
+		display_text(14, 55, statusTurnX);
+		break;
 
-		if(byte0 == 0x1B){ //DOWN, S
-			// Erase currently rendern selection box by rendering it black
-			render_selection_box(selX, selY, 0x0000);
-			render_gameBoard();
-			selY = selY + 63;
-			
-			// Loop back to the first box
-			if (selY == 214){
-				selY = 25;
-			}
-			
-			render_selection_box(selX, selY, 0xF800);
+	case ACTION_COMPUTER: //C , Toggle single player mode
+		session.flags ^= SESSION_VS_COMPUTER;
+		if (view == VIEW_GAME){
+			display_board_text();
 		}
-	
-		if(byte0 == 0x1C){ //LEFT, A
-			// Erase currently rendern selection box by rendering it black
-			render_selection_box(selX, selY, 0x0000);
-			render_gameBoard();
-			selX = selX - 90;
-			
-			// Loop back to the first box
-			if (selX == -65){
-				selX = 205;
-			}
-			
-			render_selection_box(selX, selY, 0xF800);
+		
+		// Let the computer move if it is already its turn
+		if ((session.flags & SESSION_VS_COMPUTER) && session.turn == 'O' && session.result == NO_WINNER){
+			computerPending = true;
 		}
+		break;
 
-		if(byte0 == 0x23){ //RIGHT, D
-			// Erase currently rendern selection box by rendering it black
-			render_selection_box(selX, selY, 0x0000);
-			render_gameBoard();
-			selX = selX + 90;
-			
-			// Loop back to the first box
-			if (selX == 295){
-				selX = 25;
-			}
-			
-			render_selection_box(selX, selY, 0xF800);
-		}
+	case ACTION_SCOREBOARD: //B , SCOREBOARD
+		set_view(VIEW_TEXT);
+		delete_text();
+
+		display_text(34, 20, "SCORE BOARD");
+		display_text(36, 30, "X:      ");
 
-		if(byte0 == 0x29){  //SpaceBar , Restart Game
-			delete_screen(0,0,0x0000); 
-			delete_text();
-			render_gameBoard();
-			
-			Turn = 'X';
-			memset(gameBoard, 0, sizeof(gameBoard));
-			
-			char delete_winner_status[150] = "                                                     \0";                             
-			display_text(14, 55, delete_winner_status);
-			
-			// Reinitialize selection box to the top left box
-			selX = 25;
-			selY = 25;
-			render_selection_box(selX, selY, 0xF800);
-			
-			char player_status[150] = "                    Player X's Turn!                      \0";
-			display_text(14, 55, player_status);
-			isDraw = false;
-
-		}  
-		if(byte0 == 0x32){  //B , SCOREBOARD
-			delete_screen(0,0,0x0000); 
-			delete_text();
-
-			display_text(34, 20, "SCORE BOARD");
-			display_text(36, 30, "X:      ");
-
-    		sprintf(scoreStr, "%d", xScore); // Convert xScore to string
+    		sprintf(scoreStr, "%d", session.xScore); // Convert xScore to string
     		display_text(39, 30, scoreStr); // Display xScore
 
-			display_text(36, 34, "O:      ");
-    		sprintf(scoreStr, "%d", OScore); // Convert OScore to string
+		display_text(36, 34, "O:      ");
+    		sprintf(scoreStr, "%d", session.OScore); // Convert OScore to string
     		display_text(39, 34, scoreStr); // Display OScore
 
-			display_text(17, 38, "TOTAL MATCHES PLAYED:");
-			sprintf(scoreStr, "%d", totalMatchesPlayed); // Convert OScore to string
+		display_text(17, 38, "TOTAL MATCHES PLAYED:");
+		sprintf(scoreStr, "%u", session.totalMatchesPlayed); // Convert totalMatchesPlayed to string
     		display_text(39, 38, scoreStr); // Display OScore
 
-			display_text(25, 54, "PRESS [ESC] TO GO BACK TO GAME");
-		}
-		
-		if(byte0 == 0x16){ //Select Box 1 
-			render_selection_box(selX, selY, 0x0000);
-			render_gameBoard();
-			
-			selX = 25;
-			selY = 25;
-			
-			render_selection_box(selX, selY, 0xF800);
-		}
-		
-		if(byte0 == 0x1E){ //Select Box 2 
-			render_selection_box(selX, selY, 0x0000);
-			render_gameBoard();
-			
-			selX = 115;
-			selY = 25;
-			
-			render_selection_box(selX, selY, 0xF800);
+		display_text(25, 54, "PRESS [ESC] TO GO BACK TO GAME");
+		break;
 
-		}
+	case ACTION_PROFILE: //P, print where the time went since the last time
+		profile_dump();
+		profile_reset();
+		break;
+
+	case ACTION_SELECT_1: case ACTION_SELECT_2: case ACTION_SELECT_3:
+	case ACTION_SELECT_4: case ACTION_SELECT_5: case ACTION_SELECT_6:
+	case ACTION_SELECT_7: case ACTION_SELECT_8: case ACTION_SELECT_9: //Select Box 1-9
+		move_selection(action - ACTION_SELECT_1);
+		break;
+
+	case ACTION_HELP: //H-Help Screen
+		set_view(VIEW_TEXT);
+		delete_text();
+		display_text(28, 3, "Tic-Tac-Toe Help Screen");
+
+		display_text(8, 7, "Try to get 3 consecutive boxes to win the game!");
 		
-		if(byte0 == 0x26){ //Select Box 3 
-			render_selection_box(selX, selY, 0x0000);
-			render_gameBoard();
-			
-			selX = 205;
-			selY = 25;
-			
-			render_selection_box(selX, selY, 0xF800);
-		}
+		display_text(8, 10, "Game Controls: ");
 		
-		if(byte0 == 0x25){//Select Box 4
-			render_selection_box(selX, selY, 0x0000);
-			render_gameBoard();
-			
-			selX = 25;
-			selY = 88;
-			
-			render_selection_box(selX, selY, 0xF800);
-		}
+		display_text(8, 13, "[1]-[9]: Select gameBoard index");
 		
-		if(byte0 == 0x2E){//Select Box 5
-			render_selection_box(selX, selY, 0x0000);
-			render_gameBoard();
-			
-			selX = 115;
-			selY = 88;
-			
-			render_selection_box(selX, selY, 0xF800);
-		}
+		display_text(8, 15, "[A] or [left arrow]: Move red selection box left");
 		
-		if(byte0 == 0x36){//Select Box 6
-			render_selection_box(selX, selY, 0x0000);
-			render_gameBoard();
-			
-			selX = 205;
-			selY = 88;
-			
-			render_selection_box(selX, selY, 0xF800);
-		}
+		display_text(8, 17, "[D] or [right arrow]: Move red selection box right");
 		
-		if(byte0 == 0x3D){//Select Box 7
-			render_selection_box(selX, selY, 0x0000);
-			render_gameBoard();
-			
-			selX = 25;
-			selY = 151;
-			
-			render_selection_box(selX, selY, 0xF800);
-		}
+		display_text(8, 19, "[W] or [up arrow]: Move red selection box up");
 		
-		if(byte0 == 0x3E){//Select Box 8
-			render_selection_box(selX, selY, 0x0000);
-			render_gameBoard();
-			
-			selX = 115;
-			selY = 151;
-			
-			render_selection_box(selX, selY, 0xF800);
-		}
+		display_text(8, 21, "[S] or [down arrow]: Move red selection box down");	
 		
-		if(byte0 == 0x46){//Select Box 9
-			render_selection_box(selX, selY, 0x0000);
-			render_gameBoard();
-			
-			selX = 205;
-			selY = 151;
-			
-			render_selection_box(selX, selY, 0xF800);
-		}
+		display_text(8, 23, "[enter]: Place piece/ Make a move (either Enter key)");
 		
-		if(byte0 == 0x33){//H-Help Screen
-			delete_screen();			
-			delete_text();
-			
-			char title[100] = "Tic-Tac-Toe Help Screen\0";
-			display_text(28, 3, title);
-
-			char instructions[100] = "Try to get 3 consecutive boxes to win the game!\0";
-			display_text(8, 7, instructions);
-			
-			char controls[20] = "Game Controls: \0";
-			display_text(8, 10, controls);
-			
-			char number_keys[70] = "[1]-[9]: Select gameBoard index\0";
-			display_text(8, 13, number_keys);
-			
-			char selection_key_a[70] = "[A]: Move red selection box left\0";
-			display_text(8, 15, selection_key_a);
-			
-			char selection_key_d[70] = "[D]: Move red selection box right\0";
-			display_text(8, 17, selection_key_d);
-			
-			char selection_key_w[70] = "[W]: Move red selection box up\0";
-			display_text(8, 19, selection_key_w);
-			
-			char selection_key_s[70] = "[S]: Move red selection box down\0";
-			display_text(8, 21, selection_key_s);	
-			
-			char enter[70] = "[enter]: Place piece/ Make a move\0";
-			display_text(8, 23, enter);
-			
-			char help[70] = "[H]: Help screen\0";
-			display_text(8, 25, help);
-
-			char spacebar[70] = "[spacebar]: Restart game\0";
-			display_text(8, 29, spacebar);	
-
-			char scoreBoard[100] = "[S] Score Board\0";
-			display_text(8, 3, title);
-			
-			
-			char resume[70] = "Press [ESC] to resume the game\0";
-			display_text(8, 31, resume);	
-		}
+		display_text(8, 25, "[H]: Help screen");
+
+		display_text(8, 27, "[C]: Play against the computer");
+
+		display_text(8, 29, "[spacebar]: Restart game");	
+
+		display_text(8, 3, "Tic-Tac-Toe Help Screen");
 		
-		if(byte0 == 0x76){ //Escape - Resume game
-			delete_screen();
-			delete_text();
-			render_gameBoard();
-			render_selection_box(selX, selY, 0xF800);
-			volatile int i;
-			for (i = 0; i < 9; i++){
-				if (gameBoard[i] == 1){
-					render_player_X(i+1);
-				} else if (gameBoard[i] == 2){
-					render_player_O(i+1);
-				}
-			}
-			
-			if (Turn == 'X'){
-				Turn = 'O';
-				char player_status[150] = "                    Player O's Turn!                      \0";
-				display_text(14, 55, player_status);
-			} else {
-				Turn = 'X';
-				char player_status[150] = "                    Player X's Turn!                      \0";
-				display_text(14, 55, player_status);
-			}
-		}
 		
-		if(byte0 == 0x5A){ //Enter - place piece on gameBoard
-			// check which gameBoard index 
-			int gameBoardIndex = 0; 
-			
-			if (selX == 25 & selY == 25){
-				gameBoardIndex = 1; 
-			} else if (selX == 115 & selY == 25){
-				gameBoardIndex = 2; 
-			} else if (selX == 205 & selY == 25){
-				gameBoardIndex = 3; 
-			} else if (selX == 25 & selY == 88){
-				gameBoardIndex = 4; 
-			} else if (selX == 115 & selY == 88){
-				gameBoardIndex = 5; 
-			} else if (selX == 205 & selY == 88){
-				gameBoardIndex = 6; 
-			} else if (selX == 25 & selY == 151){
-				gameBoardIndex = 7; 
-			} else if (selX == 115 & selY == 151){
-				gameBoardIndex = 8; 
-			} else if (selX == 205 & selY == 151){
-				gameBoardIndex = 9; 
-			}
-			
-			// Only render if box is empty
-			if (gameBoard[gameBoardIndex - 1] == 0){
-				
-				// update array	
-				// 0 means empty, 1 means there is an X, 2 means there is an O
-				if (Turn == 'X'){
-					gameBoard[gameBoardIndex - 1] = 1;
-				} else {
-					gameBoard[gameBoardIndex - 1] = 2;
-				}
-				
-				// render player
-				render_player(gameBoardIndex);
-				
-				// check winner
-				int winner = check_winner();
-				
-				// No winner
-				if (winner == 0){
-					// Switch turn 
-					if (Turn == 'X'){
-						Turn = 'O';
-						char player_status[150] = "                    Player O's Turn!                      \0";
-						display_text(14, 55, player_status);
-					} else {
-						Turn = 'X';
-						char player_status[150] = "                    Player X's Turn!                      \0";
-						display_text(14, 55, player_status);
-					}
-					
-				// X wins
-				} else if (winner == 1){
-					// hide selection box
-					render_selection_box(selX, selY, 0x0000);
-					render_gameBoard();
-					
-					// show winner status & prompt new game
-					char winner_status[150] = "Player X Wins! Press [spacebar] to start a new game.\0";
-					display_text(14, 55, winner_status);
-					xScore++;
-					totalMatchesPlayed++;
-					
-					
-				// O wins
-				} else if (winner == 2){
-					// hide selection box
-					render_selection_box(selX, selY, 0x0000);
-					render_gameBoard();
-					
-					// show winner status & prompt new game
-					char winner_status[150] = "Player O Wins! Press [spacebar] to start a new game.\0";
-					display_text(14, 55, winner_status);
-					OScore++;
-					totalMatchesPlayed++;
-				// Draw
-				} else if (winner == 3){
-					// hide selection box
-					render_selection_box(selX, selY, 0x0000);
-					render_gameBoard();
-					
-					// show tie status & prompt new game
-					char winner_status[150] = "It's a tie! Press [spacebar] to start a new game.\0";
-					display_text(14, 55, winner_status);
-					totalMatchesPlayed++;
-				}
-			}
+		display_text(8, 31, "Press [ESC] to resume the game");	
+		break;
+
+	case ACTION_RESUME: //Escape - Resume game
+		set_view(VIEW_GAME);
+		move_selection(session.selection);
+		delete_text();
+		display_board_text();
+
+		// The game carries on with whoever was to move
+		if (session.turn == 'O'){
+			display_text(14, 55, statusTurnO);
+		} else {
+			display_text(14, 55, statusTurnX);
 		}
-				
-		if(byte0 == 0xF0) {
-			// Check for break
-			switch (PS2_data & 0xFF) {
-				case 0x1D:
-					break;
-				case 0x1B:
-					break;
-				case 0x1C:
-					break;
-				case 0x23:
-					break;
-				default:
-					break;
-			}	
+		break;
+
+	case ACTION_PLACE: //Enter - place piece on gameBoard
+		// Only render if box is empty, in single player mode the computer answers next
+		if (place_piece(session.selection + 1) == NO_WINNER && (session.flags & SESSION_VS_COMPUTER) && session.turn == 'O'){
+			computerPending = true;
 		}
-					
-	} 
-	return;
+		break;
+	}
 }
 
-void render_line(int x0, int y0, int x1, int y1, short int line_color) {
-    bool is_steep = ( abs(y1 - y0) > abs(x1 - x0) );
+// Places the current player's piece on a box (1-9), renders it and updates the status line.
+// Returns -1 if the box is taken or the game is over, otherwise the check_winner result.
+int place_piece(int gameBoardIndex){
+	// update the bitboards, check winner, switch turn and count the result
+	int line;
+	unsigned int start = profile_begin();
+	int winner = session_move(&session, gameBoardIndex - 1, &line);
+	profile_end(PROFILE_WINNER, start);
+	if (winner == SESSION_ILLEGAL){
+		return -1;
+	}
+	
+	// the piece shows up once the box is redrawn
+	mark_cell(gameBoardIndex);
+	mark_strike(line);
+	
+	// hide selection box once the game is over
+	if (winner != NO_WINNER && selectionVisible){
+		mark_selection_box();
+		selectionVisible = false;
+	}
+	
+	// No winner
+	if (winner == 0){
+		if (session.turn == 'O'){
+			display_text(14, 55, statusTurnO);
+		} else {
+			display_text(14, 55, statusTurnX);
+		}
+		
+	// X wins
+	} else if (winner == 1){
+		// show winner status & prompt new game
+		display_text(14, 55, "Player X Wins! Press [spacebar] to start a new game.");
+		
+	// O wins
+	} else if (winner == 2){
+		// show winner status & prompt new game
+		display_text(14, 55, "Player O Wins! Press [spacebar] to start a new game.");
+	// Draw
+	} else if (winner == 3){
+		// show tie status & prompt new game
+		display_text(14, 55, "It's a tie! Press [spacebar] to start a new game.");
+	}
 	
-    if (is_steep) {
-        swap(&x0, &y0);
-        swap(&x1, &y1);
-    }
-   
-    if (x0 > x1) {
-        swap(&x0, &x1);
-        swap(&y0, &y1);
-    }
-    
-    int delta_x = x1 - x0;
-    int delta_y = abs(y1 - y0);
-    int error = -(delta_x / 2);
-    
-    int y = y0;
-    int y_step;
-    if (y0 < y1) 
-        y_step =1;
-    else 
-        y_step = -1;
-    volatile int x;
-    for(x = x0; x <= x1; x++) {
-        if (is_steep) 
-            draw_pixel(y, x, line_color);
-        else 
-            draw_pixel(x, y, line_color);
-        
-        error += delta_y;
-        
-        if (error >= 0) {
-            y +=y_step;
-            error -= delta_x;
-        }
-    } 
+	return winner;
 }
 
-void swap(int *first, int *second){
-	int temp = *first;
-    *first = *second;
-    *second = temp;   
+// Lets the computer play its perfect move for the current player
+void computer_move(void){
+	unsigned int start = profile_begin();
+	int move = ai_best_move(session.board);
+	profile_end(PROFILE_AI, start);
+	if (move != AI_NO_MOVE){
+		place_piece(move + 1);
+	}
 }
 
+// Grid lines are 3 pixels wide, centred on the box edges
 void render_gameBoard(void){
-	render_line(114, 25, 114, 213, 0XFFFF);
-	render_line(115, 25, 115, 213, 0XFFFF);
-	render_line(116, 25, 116, 213, 0XFFFF);
-	
-	render_line(204, 25, 204, 213, 0XFFFF);
-	render_line(205, 25, 205, 213, 0XFFFF);
-	render_line(206, 25, 206, 213, 0XFFFF);
+	static const RasterSegment grid[4] = {
+		{115, 25, 115, 213}, {205, 25, 205, 213}, // Columns
+		{25, 88, 295, 88}, {25, 151, 295, 151} // Rows
+	};
+	pixelWrites += raster_segments(framebufferStart, &clip, grid, 4, 3, 0xFFFF);
+}
 
-	render_line(25, 87, 295, 87, 0XFFFF);
-	render_line(25, 88, 295, 88, 0XFFFF);
-	render_line(25, 89, 295, 89, 0XFFFF);
-	
-	render_line(25, 150, 295, 150, 0XFFFF);
-	render_line(25, 151, 295, 151, 0XFFFF);
-	render_line(25, 152, 295, 152, 0XFFFF);
-	
-	char text_top_row[100] = "Welcome to Tic-Tac-Toe!\0";
-	display_text(28, 3, text_top_row);
+void display_board_text(void){
+	display_text(28, 3, "Welcome to Tic-Tac-Toe!");
 	
 	// Top left box 
-	char top_left_box_number[10] = "1\0";
-	display_text(8, 7, top_left_box_number);
+	display_text(8, 7, "1");
 	
 	// Top middle box 
-	char top_middle_box_number[10] = "2\0";
-	display_text(30, 7, top_middle_box_number);
+	display_text(30, 7, "2");
 	
 	// Top right box 
-	char top_right_box_number[10] = "3\0";
-	display_text(53, 7, top_right_box_number);
+	display_text(53, 7, "3");
 	
 	// Middle left box 
-	char middle_left_box_number[10] = "4\0";
-	display_text(8, 24, middle_left_box_number);
+	display_text(8, 24, "4");
 	
 	// Middle middle box 
-	char middle_middle_box_number[10] = "5\0";
-	display_text(30, 24, middle_middle_box_number);
+	display_text(30, 24, "5");
 	
 	// Middle right box 
-	char middle_right_box_number[10] = "6\0";
-	display_text(53, 24, middle_right_box_number);
+	display_text(53, 24, "6");
 	
 	// Bottom left box 
-	char bottom_left_box_number[10] = "7\0";
-	display_text(8, 39, bottom_left_box_number);
+	display_text(8, 39, "7");
 	
 	// Bottom middle box 
-	char bottom_middle_box_number[10] = "8\0";
-	display_text(30, 39, bottom_middle_box_number);
+	display_text(30, 39, "8");
 	
 	// Bottom right box 
-	char bottom_right_box_number[10] = "9\0";
-	display_text(53, 39, bottom_right_box_number);
+	display_text(53, 39, "9");
 	
-	char winner_status[50] = "Press [H] for help screen.";
-	display_text(5, 57, winner_status);
+	if (session.flags & SESSION_VS_COMPUTER){
+		display_text(24, 53, "Single player: computer is O");
+	} else {
+		display_text(24, 53, "                            ");
+	}
+	
+	display_text(5, 57, "Press [H] for help screen.");
 	display_text(50, 57, "Press [B] for Score Board");
 
 }
 
-void display_text(int x, int y, char * text_ptr) {
-	int offset;
-	volatile char * character_buffer = (char *)0xC9000000; // video character buffer
-	
-	/* assume that the text string fits on one line */
-	offset = (y << 7) + x;
-	
-	while (*(text_ptr)) {
-		*(character_buffer + offset) = *(text_ptr); // write to the character buffer
-		++text_ptr;
-		++offset;
-	}
+// Text shows up in the character buffer at the end of the key, only where it changed
+void display_text(int x, int y, const char * text_ptr) {
+	text_write(x, y, text_ptr);
 }
 
 
 void render_selection_box(int x, int y, short int selection_colour) {
-	render_line(x, y, x + 90, y, selection_colour);
-	render_line(x + 90, y, x + 90, y + 63, selection_colour);
-	render_line(x + 90, y + 63, x, y + 63, selection_colour);
-	render_line(x, y + 63, x, y, selection_colour);
-}
-
-void render_player(int gameBoardIndex){
-	if(Turn == 'X'){
-		render_player_X(gameBoardIndex);
-	} else {
-		render_player_O(gameBoardIndex);
-	}
+	RasterSegment edges[4] = {
+		{x, y, x + 90, y}, {x + 90, y, x + 90, y + 63},
+		{x + 90, y + 63, x, y + 63}, {x, y + 63, x, y}
+	};
+	pixelWrites += raster_segments(framebufferStart, &clip, edges, 4, 1, selection_colour);
 }
 
-void render_player_X(int gameBoardIndex){
-	// left diagonal coordinates
-	int initial_left_X0 = 29, initial_left_Y0 = 29, initial_left_X1 = 111, initial_left_Y1 = 84;
-	// right diagonal coordinates
-	int initial_right_X0 = 111, initial_right_Y0 = 29, initial_right_X1 = 29, initial_right_Y1 = 84;
-	
-	if(gameBoardIndex == 1){
-		render_line(initial_left_X0, initial_left_Y0, initial_left_X1, initial_left_Y1, 0xFFFF);
-		render_line(initial_right_X0, initial_right_Y0, initial_right_X1, initial_right_Y1, 0xFFFF);
-		
-	} else if(gameBoardIndex == 2){
-		render_line(initial_left_X0 + 90, initial_left_Y0, initial_left_X1 + 90, initial_left_Y1, 0xFFFF);
-		render_line(initial_right_X0 + 90, initial_right_Y0, initial_right_X1 + 90, initial_right_Y1, 0xFFFF);	
-		
-	} else if(gameBoardIndex == 3){
-		render_line(initial_left_X0 + 180, initial_left_Y0, initial_left_X1 + 180, initial_left_Y1, 0xFFFF);
-		render_line(initial_right_X0 + 180, initial_right_Y0, initial_right_X1 + 180, initial_right_Y1, 0xFFFF);	
-		
-	} else if(gameBoardIndex == 4){
-		render_line(initial_left_X0, initial_left_Y0 + 63, initial_left_X1, initial_left_Y1 + 63, 0xFFFF);
-		render_line(initial_right_X0, initial_right_Y0 + 63, initial_right_X1, initial_right_Y1 + 63, 0xFFFF);
-	
-	} else if(gameBoardIndex == 5){
-		render_line(initial_left_X0 + 90, initial_left_Y0 + 63, initial_left_X1 + 90, initial_left_Y1 + 63, 0xFFFF);
-		render_line(initial_right_X0 + 90, initial_right_Y0 + 63, initial_right_X1 + 90, initial_right_Y1 + 65, 0xFFFF);
-		
-	} else if(gameBoardIndex == 6){
-		render_line(initial_left_X0 + 180, initial_left_Y0 + 63, initial_left_X1 + 180, initial_left_Y1 + 63, 0xFFFF);
-		render_line(initial_right_X0 + 180, initial_right_Y0 + 63, initial_right_X1 + 180, initial_right_Y1 + 63, 0xFFFF);
-		
-	} else if(gameBoardIndex == 7){
-		render_line(initial_left_X0, initial_left_Y0 + 126, initial_left_X1, initial_left_Y1 + 126, 0xFFFF);
-		render_line(initial_right_X0, initial_right_Y0 + 126, initial_right_X1, initial_right_Y1 + 126, 0xFFFF);
-		
-	} else if(gameBoardIndex == 8){
-		render_line(initial_left_X0 + 90, initial_left_Y0 + 126, initial_left_X1 + 90, initial_left_Y1 + 126, 0xFFFF);
-		render_line(initial_right_X0 + 90, initial_right_Y0 + 126, initial_right_X1 + 90, initial_right_Y1 + 126, 0xFFFF);
-		
-	} else if(gameBoardIndex == 9){
-		render_line(initial_left_X0 + 180, initial_left_Y0 + 126, initial_left_X1 + 180, initial_left_Y1 + 126, 0xFFFF);
-		render_line(initial_right_X0 + 180, initial_right_Y0 + 126, initial_right_X1 + 180, initial_right_Y1 + 126, 0xFFFF);
-	}
-}
-	
-void render_player_O(int gameBoardIndex){
-	int UpLine_R_X = 98, UpLine_R_Y = 27, UpLine_L_X = 42, UpLine_L_Y = 27;
-	int BottomLine_R_X = 98, BottomLine_R_Y = 86, BottomLine_L_X = 42, BottomLine_L_Y = 86;
-	
-	int LeftLine_U_X = 30, LeftLine_U_Y = 31, LeftLine_B_X = 30, LeftLine_B_Y = 82; 
-	int RightLine_U_X = 110, RightLine_U_Y = 31, RightLine_B_X = 110, RightLine_B_Y = 82; 
-	
-	if(gameBoardIndex == 1){
-		render_line(UpLine_R_X, UpLine_R_Y, UpLine_L_X, UpLine_L_Y, 0xFFFF);
-		render_line(UpLine_L_X, UpLine_L_Y, LeftLine_U_X, LeftLine_U_Y, 0xFFFF);
-		render_line(LeftLine_U_X, LeftLine_U_Y, LeftLine_B_X, LeftLine_B_Y, 0xFFFF);
-		render_line(LeftLine_B_X, LeftLine_B_Y, BottomLine_L_X, BottomLine_L_Y, 0xFFFF);
-		render_line(BottomLine_L_X, BottomLine_L_Y, BottomLine_R_X, BottomLine_R_Y, 0xFFFF);
-		render_line(BottomLine_R_X, BottomLine_R_Y, RightLine_B_X, RightLine_B_Y, 0xFFFF);
-		render_line(RightLine_B_X, RightLine_B_Y, RightLine_U_X, RightLine_U_Y, 0xFFFF);
-		render_line(RightLine_U_X, RightLine_U_Y, UpLine_R_X, UpLine_R_Y, 0xFFFF);
-		
-	} else if(gameBoardIndex == 2){
-		render_line(UpLine_R_X + 90, UpLine_R_Y, UpLine_L_X + 90, UpLine_L_Y, 0xFFFF);
-		render_line(UpLine_L_X + 90, UpLine_L_Y, LeftLine_U_X + 90, LeftLine_U_Y, 0xFFFF);
-		render_line(LeftLine_U_X + 90, LeftLine_U_Y, LeftLine_B_X + 90, LeftLine_B_Y, 0xFFFF);
-		render_line(LeftLine_B_X + 90, LeftLine_B_Y, BottomLine_L_X + 90, BottomLine_L_Y, 0xFFFF);
-		render_line(BottomLine_L_X + 90, BottomLine_L_Y, BottomLine_R_X + 90, BottomLine_R_Y, 0xFFFF);
-		render_line(BottomLine_R_X + 90, BottomLine_R_Y, RightLine_B_X + 90, RightLine_B_Y, 0xFFFF);
-		render_line(RightLine_B_X + 90, RightLine_B_Y, RightLine_U_X + 90, RightLine_U_Y, 0xFFFF);
-		render_line(RightLine_U_X + 90, RightLine_U_Y, UpLine_R_X + 90, UpLine_R_Y, 0xFFFF);
-		
-	} else if(gameBoardIndex == 3){
-		render_line(UpLine_R_X + 180, UpLine_R_Y, UpLine_L_X + 180, UpLine_L_Y, 0xFFFF);
-		render_line(UpLine_L_X + 180, UpLine_L_Y, LeftLine_U_X + 180, LeftLine_U_Y, 0xFFFF);
-		render_line(LeftLine_U_X + 180, LeftLine_U_Y, LeftLine_B_X + 180, LeftLine_B_Y, 0xFFFF);
-		render_line(LeftLine_B_X + 180, LeftLine_B_Y, BottomLine_L_X + 180, BottomLine_L_Y, 0xFFFF);
-		render_line(BottomLine_L_X + 180, BottomLine_L_Y, BottomLine_R_X + 180, BottomLine_R_Y, 0xFFFF);
-		render_line(BottomLine_R_X + 180, BottomLine_R_Y, RightLine_B_X + 180, RightLine_B_Y, 0xFFFF);
-		render_line(RightLine_B_X + 180, RightLine_B_Y, RightLine_U_X + 180, RightLine_U_Y, 0xFFFF);
-		render_line(RightLine_U_X + 180, RightLine_U_Y, UpLine_R_X + 180, UpLine_R_Y, 0xFFFF);
-				
-	} else if(gameBoardIndex == 4){
-		render_line(UpLine_R_X, UpLine_R_Y + 63, UpLine_L_X, UpLine_L_Y + 63, 0xFFFF);
-		render_line(UpLine_L_X, UpLine_L_Y + 63, LeftLine_U_X, LeftLine_U_Y + 63, 0xFFFF);
-		render_line(LeftLine_U_X, LeftLine_U_Y + 63, LeftLine_B_X, LeftLine_B_Y + 63, 0xFFFF);
-		render_line(LeftLine_B_X, LeftLine_B_Y + 63, BottomLine_L_X, BottomLine_L_Y + 63, 0xFFFF);
-		render_line(BottomLine_L_X, BottomLine_L_Y + 63, BottomLine_R_X, BottomLine_R_Y + 63, 0xFFFF);
-		render_line(BottomLine_R_X, BottomLine_R_Y + 63, RightLine_B_X, RightLine_B_Y + 63, 0xFFFF);
-		render_line(RightLine_B_X, RightLine_B_Y + 63, RightLine_U_X, RightLine_U_Y + 63, 0xFFFF);
-		render_line(RightLine_U_X, RightLine_U_Y + 63, UpLine_R_X, UpLine_R_Y + 63, 0xFFFF);
-
-	} else if(gameBoardIndex == 5){
-		render_line(UpLine_R_X + 90, UpLine_R_Y + 63, UpLine_L_X + 90, UpLine_L_Y + 63, 0xFFFF);
-		render_line(UpLine_L_X + 90, UpLine_L_Y + 63, LeftLine_U_X + 90, LeftLine_U_Y + 63, 0xFFFF);
-		render_line(LeftLine_U_X + 90, LeftLine_U_Y + 63, LeftLine_B_X + 90, LeftLine_B_Y + 63, 0xFFFF);
-		render_line(LeftLine_B_X + 90, LeftLine_B_Y + 63, BottomLine_L_X + 90, BottomLine_L_Y + 63, 0xFFFF);
-		render_line(BottomLine_L_X + 90, BottomLine_L_Y + 63, BottomLine_R_X + 90, BottomLine_R_Y + 63, 0xFFFF);
-		render_line(BottomLine_R_X + 90, BottomLine_R_Y + 63, RightLine_B_X + 90, RightLine_B_Y + 63, 0xFFFF);
-		render_line(RightLine_B_X + 90, RightLine_B_Y + 63, RightLine_U_X + 90, RightLine_U_Y + 63, 0xFFFF);
-		render_line(RightLine_U_X + 90, RightLine_U_Y + 63, UpLine_R_X + 90, UpLine_R_Y + 63, 0xFFFF);
-	
-	} else if(gameBoardIndex == 6){
-		render_line(UpLine_R_X + 180, UpLine_R_Y + 63, UpLine_L_X + 180, UpLine_L_Y + 63, 0xFFFF);
-		render_line(UpLine_L_X + 180, UpLine_L_Y + 63, LeftLine_U_X + 180, LeftLine_U_Y + 63, 0xFFFF);
-		render_line(LeftLine_U_X + 180, LeftLine_U_Y + 63, LeftLine_B_X + 180, LeftLine_B_Y + 63, 0xFFFF);
-		render_line(LeftLine_B_X + 180, LeftLine_B_Y + 63, BottomLine_L_X + 180, BottomLine_L_Y + 63, 0xFFFF);
-		render_line(BottomLine_L_X + 180, BottomLine_L_Y + 63, BottomLine_R_X + 180, BottomLine_R_Y + 63, 0xFFFF);
-		render_line(BottomLine_R_X + 180, BottomLine_R_Y + 63, RightLine_B_X + 180, RightLine_B_Y + 63, 0xFFFF);
-		render_line(RightLine_B_X + 180, RightLine_B_Y + 63, RightLine_U_X + 180, RightLine_U_Y + 63, 0xFFFF);
-		render_line(RightLine_U_X + 180, RightLine_U_Y + 63, UpLine_R_X + 180, UpLine_R_Y + 63, 0xFFFF);
-		
-	} else if(gameBoardIndex == 7){
-		render_line(UpLine_R_X, UpLine_R_Y + 126, UpLine_L_X, UpLine_L_Y + 126, 0xFFFF);
-		render_line(UpLine_L_X, UpLine_L_Y + 126, LeftLine_U_X, LeftLine_U_Y + 126, 0xFFFF);
-		render_line(LeftLine_U_X, LeftLine_U_Y + 126, LeftLine_B_X, LeftLine_B_Y + 126, 0xFFFF);
-		render_line(LeftLine_B_X, LeftLine_B_Y + 126, BottomLine_L_X, BottomLine_L_Y + 126, 0xFFFF);
-		render_line(BottomLine_L_X, BottomLine_L_Y + 126, BottomLine_R_X, BottomLine_R_Y + 126, 0xFFFF);
-		render_line(BottomLine_R_X, BottomLine_R_Y + 126, RightLine_B_X, RightLine_B_Y + 126, 0xFFFF);
-		render_line(RightLine_B_X, RightLine_B_Y + 126, RightLine_U_X, RightLine_U_Y + 126, 0xFFFF);
-		render_line(RightLine_U_X, RightLine_U_Y + 126, UpLine_R_X, UpLine_R_Y + 126, 0xFFFF);
-		
-	} else if(gameBoardIndex == 8){
-		render_line(UpLine_R_X + 90, UpLine_R_Y + 126, UpLine_L_X + 90, UpLine_L_Y + 126, 0xFFFF);
-		render_line(UpLine_L_X + 90, UpLine_L_Y + 126, LeftLine_U_X + 90, LeftLine_U_Y + 126, 0xFFFF);
-		render_line(LeftLine_U_X + 90, LeftLine_U_Y + 126, LeftLine_B_X + 90, LeftLine_B_Y + 126, 0xFFFF);
-		render_line(LeftLine_B_X + 90, LeftLine_B_Y + 126, BottomLine_L_X + 90, BottomLine_L_Y + 126, 0xFFFF);
-		render_line(BottomLine_L_X + 90, BottomLine_L_Y + 126, BottomLine_R_X + 90, BottomLine_R_Y + 126, 0xFFFF);
-		render_line(BottomLine_R_X + 90, BottomLine_R_Y + 126, RightLine_B_X + 90, RightLine_B_Y + 126, 0xFFFF);
-		render_line(RightLine_B_X + 90, RightLine_B_Y + 126, RightLine_U_X + 90, RightLine_U_Y + 126, 0xFFFF);
-		render_line(RightLine_U_X + 90, RightLine_U_Y + 126, UpLine_R_X + 90, UpLine_R_Y + 126, 0xFFFF);
-		
-	} else if(gameBoardIndex == 9){
-		render_line(UpLine_R_X + 180, UpLine_R_Y + 126, UpLine_L_X + 180, UpLine_L_Y + 126, 0xFFFF);
-		render_line(UpLine_L_X + 180, UpLine_L_Y + 126, LeftLine_U_X + 180, LeftLine_U_Y + 126, 0xFFFF);
-		render_line(LeftLine_U_X + 180, LeftLine_U_Y + 126, LeftLine_B_X + 180, LeftLine_B_Y + 126, 0xFFFF);
-		render_line(LeftLine_B_X + 180, LeftLine_B_Y + 126, BottomLine_L_X + 180, BottomLine_L_Y + 126, 0xFFFF);
-		render_line(BottomLine_L_X + 180, BottomLine_L_Y + 126, BottomLine_R_X + 180, BottomLine_R_Y + 126, 0xFFFF);
-		render_line(BottomLine_R_X + 180, BottomLine_R_Y + 126, RightLine_B_X + 180, RightLine_B_Y + 126, 0xFFFF);
-		render_line(RightLine_B_X + 180, RightLine_B_Y + 126, RightLine_U_X + 180, RightLine_U_Y + 126, 0xFFFF);
-		render_line(RightLine_U_X + 180, RightLine_U_Y + 126, UpLine_R_X + 180, UpLine_R_Y + 126, 0xFFFF);
-	}
+void render_piece(int gameBoardIndex, const Sprite *sprite){
+	pixelWrites += sprite_blit(framebufferStart, &clip, sprite, cellOrigin[gameBoardIndex - 1][0],
+		cellOrigin[gameBoardIndex - 1][1], 0xFFFF);
 }
 
 void start_screen(){
-	int offset = 20, offset2 = 15;
-	volatile int x,y;
-	for (x = 0; x < 320; x++){
-		for ( y = 0; y < 240; y++){
-			draw_pixel(x, y, 0x00FF);
-		}
-	}
+	// The blue background is painted by repaint_rect while the title view is showing
  // Calculating the centers for each string
     int welcome_center = (80 - strlen("WELCOME")) / 2;
     int to_the_center = (80 - strlen("TO THE")) / 2;
@@ -925,145 +800,27 @@ void start_screen(){
 
 }
 
-// Functions checks every possibly win (3 in a row) for either player and returns the winner
-int check_winner(){
-	// First Column Win
-    if(1 == gameBoard[0] && 1 == gameBoard[3] && 1 == gameBoard[6]){
-		render_line(69, 25, 69, 214, 0xF800);
-		render_line(70, 25, 70, 214, 0xF800);
-		render_line(71, 25, 71, 214, 0xF800);
-        return 1;
-    }
-
-    if(2 == gameBoard[0] && 2 == gameBoard[3] && 2 == gameBoard[6]){
-		render_line(69, 25, 69, 214, 0xF800);
-		render_line(70, 25, 70, 214, 0xF800);
-		render_line(71, 25, 71, 214, 0xF800);
-        return 2;
-    }
-	
-	// Second Column Win 
-    if(1 == gameBoard[1] && 1 == gameBoard[4] && 1 == gameBoard[7]){
-		render_line(159, 25, 159, 214, 0xF800);
-		render_line(160, 25, 160, 214, 0xF800);
-		render_line(161, 25, 161, 214, 0xF800);
-        return 1;
-    }
-
-    if(2 == gameBoard[1] && 2 == gameBoard[4] && 2 == gameBoard[7]){
-		render_line(159, 25, 159, 214, 0xF800);
-		render_line(160, 25, 160, 214, 0xF800);
-		render_line(161, 25, 161, 214, 0xF800);
-        return 2;
-    }
-	
-	// Third column win 
-	if(1 == gameBoard[2] && 1 == gameBoard[5] && 1 == gameBoard[8]){
-		render_line(249, 25, 249, 214, 0xF800);
-		render_line(250, 25, 250, 214, 0xF800);
-		render_line(251, 25, 251, 214, 0xF800);
-        return 1;
-    }
-
-    if(2 == gameBoard[2] && 2 == gameBoard[5] && 2 == gameBoard[8]){
-		render_line(249, 25, 249, 214, 0xF800);
-		render_line(250, 25, 250, 214, 0xF800);
-		render_line(251, 25, 251, 214, 0xF800);        
-		return 2;
-    }
-	
-	// First row Win
-    if(1 == gameBoard[0] && 1 == gameBoard[1] && 1 == gameBoard[2]){
-		render_line(25, 55, 295, 55, 0xF800);
-		render_line(25, 56, 295, 56, 0xF800);
-		render_line(25, 57, 295, 57, 0xF800);
-        return 1;
-    }
-
-    if(2 == gameBoard[0] && 2 == gameBoard[1] && 2 == gameBoard[2]){
-		render_line(25, 55, 295, 55, 0xF800);
-		render_line(25, 56, 295, 56, 0xF800);
-		render_line(25, 57, 295, 57, 0xF800);
-        return 2;
-    }
-	
-	// Second row Win 
-    if(1 == gameBoard[3] && 1 == gameBoard[4] && 1 == gameBoard[5]){
-		render_line(25, 118, 295, 118, 0xF800);
-		render_line(25, 119, 295, 119, 0xF800);
-		render_line(25, 120, 295, 120, 0xF800);
-        return 1;
-    }
-
-    if(2 == gameBoard[3] && 2 == gameBoard[4] && 2 == gameBoard[5]){
-		render_line(25, 118, 295, 118, 0xF800);
-		render_line(25, 119, 295, 119, 0xF800);
-		render_line(25, 120, 295, 120, 0xF800);
-        return 2;
-    }
-	
-	// Third row win 
-	if(1 == gameBoard[6] && 1 == gameBoard[7] && 1 == gameBoard[8]){
-		render_line(25, 181, 295, 181, 0xF800);
-		render_line(25, 182, 295, 182, 0xF800);
-		render_line(25, 183, 295, 183, 0xF800);
-        return 1;
-    }
-
-    if(2 == gameBoard[6] && 2 == gameBoard[7] && 2 == gameBoard[8]){
-		render_line(25, 181, 295, 181, 0xF800);
-		render_line(25, 182, 295, 182, 0xF800);
-		render_line(25, 183, 295, 183, 0xF800);
-        return 2;
-    }
-	
-	// Left diagonal win
-    if(1 == gameBoard[0] && 1 == gameBoard[4] && 1 == gameBoard[8]){
-		render_line(24, 24, 294, 213, 0xF800);
-		render_line(25, 25, 295, 214, 0xF800);
-		render_line(26, 26, 296, 215, 0xF800);
-        return 1;
-    }
-
-    if(2 == gameBoard[0] && 2 == gameBoard[4] && 2 == gameBoard[8]){
-		render_line(24, 24, 294, 213, 0xF800);
-		render_line(25, 25, 295, 214, 0xF800);
-		render_line(26, 26, 296, 215, 0xF800);
-        return 2;
-    }
-    
-	// Right diagonal win
-    if(1 == gameBoard[2] && 1 == gameBoard[4] && 1 == gameBoard[6]){
-		render_line(294, 24, 24, 213, 0xF800);
-		render_line(295, 25, 25, 214, 0xF800);
-		render_line(296, 26, 26, 215, 0xF800);
-        return 1;
-    }
-    
-    if (2 == gameBoard[2] && 2 == gameBoard[4] && 2 == gameBoard[6]){
-		render_line(294, 24, 24, 213, 0xF800);
-		render_line(295, 25, 25, 214, 0xF800);
-		render_line(296, 26, 26, 215, 0xF800);
-        return 2;
-    }
-	
-	checkforDraw();
-	if (isDraw){
-		return 3;
-	}
-	
-	return 0;
+// Checks every possible win (3 in a row) for either player and returns the winner.
+// Only looks at the board, drawing the strike is left to render_strike.
+int check_winner(int *line){
+	return board_evaluate(session.board, line);
 }
 
-// Checks if every position has been filled
-void checkforDraw(){
-	volatile index = 0;
-    for( index = 0; index < 9; index++){
-        // 0 means no one has claimed that position
-        if(gameBoard[index] == 0){
-            isDraw = false;
-			return;
-        }
-    }
-	isDraw = true;
+// Draws the red strike-through for a line returned by check_winner. Rows and columns are one
+// 3 pixel band, diagonals stay three 1 pixel lines offset along the diagonal as they always were.
+void render_strike(int line){
+	const RasterSegment *strike;
+	int offset;
+	if (line == NO_LINE){
+		return;
+	}
+	strike = &strikeSegments[line];
+	if (strike->x0 == strike->x1 || strike->y0 == strike->y1){
+		pixelWrites += raster_line(framebufferStart, &clip, strike->x0, strike->y0, strike->x1, strike->y1, 3, 0xF800);
+		return;
+	}
+	for (offset = -1; offset <= 1; offset++){
+		pixelWrites += raster_line(framebufferStart, &clip, strike->x0 + offset, strike->y0 + offset,
+			strike->x1 + offset, strike->y1 + offset, 1, 0xF800);
+	}
 }
@@ -0,0 +1,157 @@
+
+#include <stdio.h> // Include Standard Input Output Library for the report
+#include <stdlib.h> // Include Standard Library for atoi and abs
+#include <time.h> // Include Time Library for clock_gettime
+
+#include "../device.h" // Screen size and row pitch
+#include "../raster.h" // Fill primitives
+
+// Fill bandwidth and line speed of the raster primitives against the per-pixel paths they replaced.
+// gcc -O2 -o bench_raster tools/bench_raster.c raster.c          (SSE2)
+// gcc -O2 -mavx -o bench_raster tools/bench_raster.c raster.c    (AVX)
+// ./bench_raster [full-screen fills per test]
+
+static short int pixels[SCREEN_HEIGHT * (PIXEL_ROW_BYTES / 2)] __attribute__((aligned(64)));
+
+static inline long long now_ns(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// The game's draw_pixel: one call and one address computation per pixel
+__attribute__((noinline)) static void draw_pixel(uintptr_t buffer, int x, int y, short int colour) {
+	*(volatile short int *)(buffer + (y << 10) + (x << 1)) = colour;
+}
+
+// The old delete_screen and start_screen loops, x outer so every write is 1 KB further on
+static void fill_columns(uintptr_t buffer, short int colour) {
+	int x, y;
+	for (x = 0; x < SCREEN_WIDTH; x++){
+		for (y = 0; y < SCREEN_HEIGHT; y++){
+			draw_pixel(buffer, x, y, colour);
+		}
+	}
+}
+
+// Same calls in row order
+static void fill_rows(uintptr_t buffer, short int colour) {
+	int x, y;
+	for (y = 0; y < SCREEN_HEIGHT; y++){
+		for (x = 0; x < SCREEN_WIDTH; x++){
+			draw_pixel(buffer, x, y, colour);
+		}
+	}
+}
+
+static void fill_clear(uintptr_t buffer, short int colour) {
+	raster_clear(buffer, colour);
+}
+
+// One gameBoard box at a time, the size dirty rectangles usually have
+static void fill_boxes(uintptr_t buffer, short int colour) {
+	int i;
+	for (i = 0; i < 14; i++){
+		raster_rect(buffer, 26 + i % 3 * 90, 1 + i / 3 * 47, 114 + i % 3 * 90, 47 + i / 3 * 47, colour);
+	}
+}
+
+// Odd start and length so every span has a head and a tail
+static void fill_spans(uintptr_t buffer, short int colour) {
+	int y;
+	for (y = 0; y < SCREEN_HEIGHT; y++){
+		raster_span(buffer, 1 + (y & 7), SCREEN_WIDTH - 2 - (y & 3), y, colour);
+	}
+}
+
+// The game's old render_line: Bresenham through draw_pixel, steepness checked every pixel
+static void old_line(uintptr_t buffer, int x0, int y0, int x1, int y1, short int colour) {
+	int steep = abs(y1 - y0) > abs(x1 - x0), temp;
+	if (steep){
+		temp = x0; x0 = y0; y0 = temp;
+		temp = x1; x1 = y1; y1 = temp;
+	}
+	if (x0 > x1){
+		temp = x0; x0 = x1; x1 = temp;
+		temp = y0; y0 = y1; y1 = temp;
+	}
+	int deltaX = x1 - x0, deltaY = abs(y1 - y0), error = -(deltaX / 2), y = y0, step = y0 < y1 ? 1 : -1;
+	volatile int x;
+	for (x = x0; x <= x1; x++){
+		if (steep)
+			draw_pixel(buffer, y, x, colour);
+		else
+			draw_pixel(buffer, x, y, colour);
+		error += deltaY;
+		if (error >= 0){
+			y += step;
+			error -= deltaX;
+		}
+	}
+}
+
+static const RasterSegment grid[4] = {
+	{115, 25, 115, 213}, {205, 25, 205, 213}, {25, 88, 295, 88}, {25, 151, 295, 151}
+};
+static const RasterRect screen = {0, 0, SCREEN_WIDTH - 1, SCREEN_HEIGHT - 1};
+
+// The gameBoard grid and a diagonal strike, 3 pixels wide by drawing every line 3 times
+static void lines_old(uintptr_t buffer, short int colour) {
+	int i, offset;
+	for (i = 0; i < 4; i++){
+		for (offset = -1; offset <= 1; offset++){
+			if (grid[i].x0 == grid[i].x1){
+				old_line(buffer, grid[i].x0 + offset, grid[i].y0, grid[i].x1 + offset, grid[i].y1, colour);
+			} else {
+				old_line(buffer, grid[i].x0, grid[i].y0 + offset, grid[i].x1, grid[i].y1 + offset, colour);
+			}
+		}
+	}
+	for (offset = -1; offset <= 1; offset++){
+		old_line(buffer, 25 + offset, 25 + offset, 295 + offset, 214 + offset, colour);
+	}
+}
+
+// Same picture with native thick grid lines, the strike is still three offset lines
+static void lines_new(uintptr_t buffer, short int colour) {
+	int offset;
+	raster_segments(buffer, &screen, grid, 4, 3, colour);
+	for (offset = -1; offset <= 1; offset++){
+		raster_line(buffer, &screen, 25 + offset, 25 + offset, 295 + offset, 214 + offset, 1, colour);
+	}
+}
+
+static void run(const char *name, void (*fill)(uintptr_t, short int), int fills, long long pixelsPerFill) {
+	uintptr_t buffer = (uintptr_t)pixels;
+	long long start, elapsed;
+	int i;
+
+	fill(buffer, 0); // warm up
+	start = now_ns();
+	for (i = 0; i < fills; i++){
+		fill(buffer, (short int)i);
+	}
+	elapsed = now_ns() - start;
+	printf("%-24s %9.1f us per fill %9.0f MB/s %8.2f ns per pixel\n", name, elapsed / 1e3 / fills,
+		pixelsPerFill * 2.0 * fills / (elapsed * 1e-9) / 1e6, (double)elapsed / fills / pixelsPerFill);
+}
+
+int main(int argc, char **argv) {
+	int fills = argc > 1 ? atoi(argv[1]) : 2000;
+	long long screen = SCREEN_WIDTH * SCREEN_HEIGHT, spans = 0;
+	int y;
+
+	for (y = 0; y < SCREEN_HEIGHT; y++){
+		spans += SCREEN_WIDTH - 2 - (y & 3) - (y & 7);
+	}
+
+	printf("%d fills per test, raster stores: %s\n", fills, raster_isa());
+	run("draw_pixel, x outer", fill_columns, fills, screen);
+	run("draw_pixel, y outer", fill_rows, fills, screen);
+	run("raster_clear", fill_clear, fills, screen);
+	run("raster_rect, 89x47", fill_boxes, fills, 14 * 89 * 47);
+	run("raster_span, ragged", fill_spans, fills, spans);
+	run("grid + strike, old lines", lines_old, fills, 3 * (2 * 189 + 2 * 271 + 271));
+	run("grid + strike, raster", lines_new, fills, 3 * (2 * 189 + 2 * 271 + 271));
+	return 0;
+}
@@ -0,0 +1,183 @@
+
+#include <pthread.h> // Include POSIX threads for the multi-threaded run
+#include <stdio.h> // Include Standard Input Output Library for the report
+#include <stdlib.h> // Include Standard Library for atoi
+#include <string.h> // Include String Library for strcmp
+#include <time.h> // Include Time Library for clock_gettime
+
+#include "../game.h" // Bitboard game core
+#include "../ai.h" // Perfect-play table
+
+// Headless self-play throughput benchmark. Plays complete games through game_move, the
+// same placement, turn switch and win check the Enter handler uses, with no rendering.
+// gcc -O2 -pthread -o bench_selfplay tools/bench_selfplay.c game.c ai_table.c
+// ./bench_selfplay [games per thread] [threads] [X player] [O player]
+// Players: random, ai (solved table), scripted (centre, corners, then edges)
+
+#define SAMPLE_EVERY 64 // Time one move in 64, reading the clock costs about as much as a move
+#define LATENCY_BUCKETS 4096 // 1 ns buckets, slower moves land in the last one
+
+typedef enum { PLAYER_RANDOM, PLAYER_AI, PLAYER_SCRIPTED } PlayerKind;
+
+typedef struct {
+	PlayerKind players[2];
+	long long games;
+	unsigned long long seed;
+	long long moves;
+	long long results[4]; // Count per check_winner code
+	long long latency[LATENCY_BUCKETS];
+	pthread_t thread;
+} BenchThread;
+
+static const unsigned char script[BOARD_CELLS] = {4, 0, 2, 6, 8, 1, 3, 5, 7};
+static long long clockOverhead; // Cost of the two clock reads around a timed move
+
+static inline long long now_ns(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static inline int choose(BenchThread *bench, PlayerKind kind, GameBoard board) {
+	unsigned short empty = board_empty(board);
+	int i, pick;
+	switch (kind){
+	case PLAYER_AI:
+		return ai_best_move(board);
+	case PLAYER_SCRIPTED:
+		for (i = 0; !(empty & (1 << script[i])); i++);
+		return script[i];
+	default:
+		// xorshift64, then drop that many set bits
+		bench->seed ^= bench->seed << 13;
+		bench->seed ^= bench->seed >> 7;
+		bench->seed ^= bench->seed << 17;
+		pick = (int)(((bench->seed >> 32) * (unsigned long long)__builtin_popcount(empty)) >> 32);
+		while (pick--){
+			empty &= empty - 1;
+		}
+		return __builtin_ctz(empty);
+	}
+}
+
+static void * play_games(void *arg) {
+	BenchThread *bench = arg;
+	long long game;
+	int line;
+
+	for (game = 0; game < bench->games; game++){
+		GameBoard board = {0, 0};
+		char turn = 'X';
+		int winner = NO_WINNER;
+		while (winner == NO_WINNER){
+			PlayerKind kind = bench->players[turn == 'O'];
+			if ((bench->moves & (SAMPLE_EVERY - 1)) == 0){
+				long long start = now_ns(), elapsed;
+				winner = game_move(&board, choose(bench, kind, board), &turn, &line);
+				elapsed = now_ns() - start - clockOverhead;
+				elapsed = elapsed < 0 ? 0 : elapsed;
+				bench->latency[elapsed < LATENCY_BUCKETS ? elapsed : LATENCY_BUCKETS - 1]++;
+			} else {
+				winner = game_move(&board, choose(bench, kind, board), &turn, &line);
+			}
+			bench->moves++;
+		}
+		bench->results[winner]++;
+	}
+	return 0;
+}
+
+// Latency below which the given fraction of the sampled moves fall
+static int percentile(const long long *latency, long long samples, double fraction) {
+	long long seen = 0;
+	int i;
+	for (i = 0; i < LATENCY_BUCKETS; i++){
+		seen += latency[i];
+		if (seen >= samples * fraction){
+			return i;
+		}
+	}
+	return LATENCY_BUCKETS - 1;
+}
+
+static void run(int threads, long long games, const PlayerKind *players) {
+	static BenchThread bench[64];
+	static long long latency[LATENCY_BUCKETS];
+	long long moves = 0, results[4] = {0, 0, 0, 0}, samples = 0;
+	long long start, elapsed;
+	int i, j;
+
+	memset(latency, 0, sizeof(latency));
+	for (i = 0; i < threads; i++){
+		memset(&bench[i], 0, sizeof(bench[i]));
+		bench[i].players[0] = players[0];
+		bench[i].players[1] = players[1];
+		bench[i].games = games;
+		bench[i].seed = 0x9E3779B97F4A7C15ULL * (i + 1);
+	}
+	start = now_ns();
+	for (i = 0; i < threads; i++){
+		pthread_create(&bench[i].thread, 0, play_games, &bench[i]);
+	}
+	for (i = 0; i < threads; i++){
+		pthread_join(bench[i].thread, 0);
+	}
+	elapsed = now_ns() - start;
+
+	for (i = 0; i < threads; i++){
+		moves += bench[i].moves;
+		for (j = 0; j < 4; j++){
+			results[j] += bench[i].results[j];
+		}
+		for (j = 0; j < LATENCY_BUCKETS; j++){
+			latency[j] += bench[i].latency[j];
+			samples += bench[i].latency[j];
+		}
+	}
+
+	printf("%2d thread%s %12.0f games/s %13.0f moves/s   latency p50 %3d ns  p90 %3d ns  p99 %3d ns  p99.9 %4d ns"
+		"   X %lld  O %lld  draw %lld\n",
+		threads, threads == 1 ? " " : "s", games * threads / (elapsed * 1e-9), moves / (elapsed * 1e-9),
+		percentile(latency, samples, 0.5), percentile(latency, samples, 0.9),
+		percentile(latency, samples, 0.99), percentile(latency, samples, 0.999),
+		results[X_WINS], results[O_WINS], results[DRAW]);
+}
+
+static PlayerKind parse_player(const char *name) {
+	if (strcmp(name, "ai") == 0){
+		return PLAYER_AI;
+	}
+	if (strcmp(name, "scripted") == 0){
+		return PLAYER_SCRIPTED;
+	}
+	return PLAYER_RANDOM;
+}
+
+int main(int argc, char **argv) {
+	long long games = argc > 1 ? atoll(argv[1]) : 1000000;
+	int threads = argc > 2 ? atoi(argv[2]) : 4;
+	PlayerKind players[2] = {PLAYER_RANDOM, PLAYER_RANDOM};
+	int i;
+
+	if (argc > 3) players[0] = parse_player(argv[3]);
+	if (argc > 4) players[1] = parse_player(argv[4]);
+	if (threads < 1 || threads > 64){
+		fprintf(stderr, "threads must be between 1 and 64\n");
+		return 2;
+	}
+
+	// Smallest back-to-back clock read, taken off every latency sample
+	clockOverhead = 1000000;
+	for (i = 0; i < 10000; i++){
+		long long start = now_ns(), elapsed = now_ns() - start;
+		clockOverhead = elapsed < clockOverhead ? elapsed : clockOverhead;
+	}
+
+	printf("%lld games per thread, latency sampled on 1 move in %d (clock overhead %lld ns removed)\n",
+		games, SAMPLE_EVERY, clockOverhead);
+	run(1, games, players);
+	if (threads > 1){
+		run(threads, games, players);
+	}
+	return 0;
+}
@@ -0,0 +1,114 @@
+#include <stdio.h> // Include Standard Input Output Library for the report
+#include <stdlib.h> // Include Standard Library for atoi and malloc
+#include <string.h> // Include String Library for memcmp
+#include <time.h> // Include Time Library for clock_gettime
+
+#include "../session.h" // Session pool
+
+// Move throughput of the session pool. Every round sends a batch of moves to random
+// sessions, like requests from many clients arriving together, and applies it twice to
+// two pools with the same games: once through session_apply_moves, once move by move
+// without prefetching. Both must give the same results.
+// gcc -O2 -o bench_sessions tools/bench_sessions.c session.c game.c ai_table.c
+// ./bench_sessions [sessions] [rounds] [moves per batch] [percent against the computer]
+
+static inline long long now_ns(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static inline unsigned int next_random(unsigned long long *state) {
+	*state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+	return *state >> 33;
+}
+
+// What session_apply_moves does, one session at a time
+static void apply_one_by_one(SessionPool *pool, const SessionMove *moves, int count, signed char *results) {
+	Session *session;
+	int i, line, result;
+	for (i = 0; i < count; i++){
+		session = session_get(pool, moves[i].session);
+		if (moves[i].cell == SESSION_NEW_GAME){
+			session_new_game(session);
+			results[i] = NO_WINNER;
+			continue;
+		}
+		result = session_move(session, moves[i].cell, &line);
+		if (result == NO_WINNER && (session->flags & SESSION_VS_COMPUTER) && session->turn == 'O'){
+			result = session_computer_move(session, &line);
+		}
+		results[i] = result;
+	}
+}
+
+int main(int argc, char **argv) {
+	unsigned int sessions = argc > 1 ? atoi(argv[1]) : 100000;
+	int rounds = argc > 2 ? atoi(argv[2]) : 200;
+	int batch = argc > 3 ? atoi(argv[3]) : 65536;
+	int computerPercent = argc > 4 ? atoi(argv[4]) : 50;
+	SessionPool batched, single;
+	SessionMove *moves = malloc(batch * sizeof(*moves));
+	signed char *results = malloc(batch), *check = malloc(batch);
+	unsigned char *gameOver = calloc(sessions, 1); // What a client knows from the replies it got
+	unsigned long long seed = 1, legal = 0, finished = 0;
+	long long batchedNs = 0, singleNs = 0, start;
+	unsigned int i;
+	int round, m;
+
+	if (!moves || !results || !check || !gameOver
+		|| !session_pool_init(&batched, sessions) || !session_pool_init(&single, sessions)){
+		fprintf(stderr, "out of memory\n");
+		return 1;
+	}
+	for (i = 0; i < sessions; i++){
+		bool vsComputer = next_random(&seed) % 100 < (unsigned int)computerPercent;
+		session_open(&batched, vsComputer);
+		session_open(&single, vsComputer);
+	}
+
+	for (round = 0; round < rounds; round++){
+		for (m = 0; m < batch; m++){
+			moves[m].session = next_random(&seed) % sessions;
+			moves[m].cell = gameOver[moves[m].session] ? SESSION_NEW_GAME : next_random(&seed) % BOARD_CELLS;
+			gameOver[moves[m].session] = 0;
+		}
+
+		start = now_ns();
+		session_apply_moves(&batched, moves, batch, results);
+		batchedNs += now_ns() - start;
+
+		start = now_ns();
+		apply_one_by_one(&single, moves, batch, check);
+		singleNs += now_ns() - start;
+
+		if (memcmp(results, check, batch) != 0){
+			fprintf(stderr, "round %d: batched and one-by-one results differ\n", round);
+			return 1;
+		}
+		for (m = 0; m < batch; m++){
+			if (results[m] != SESSION_ILLEGAL && moves[m].cell != SESSION_NEW_GAME){
+				legal++;
+			}
+			if (results[m] > NO_WINNER){
+				gameOver[moves[m].session] = 1;
+				finished++;
+			}
+		}
+	}
+
+	printf("%u sessions, %d%% against the computer: %zu bytes each, %zu with the free list, pool %.1f MB\n",
+		sessions, computerPercent, sizeof(Session), sizeof(Session) + sizeof(unsigned int),
+		sessions * (sizeof(Session) + sizeof(unsigned int)) / 1e6);
+	printf("%d rounds of %d moves, %llu legal, %llu games finished\n", rounds, batch, legal, finished);
+	printf("batched     %8.1f M moves/s\n", (double)rounds * batch / batchedNs * 1e3);
+	printf("one by one  %8.1f M moves/s\n", (double)rounds * batch / singleNs * 1e3);
+
+	session_pool_free(&batched);
+	session_pool_free(&single);
+	free(moves);
+	free(results);
+	free(check);
+	free(gameOver);
+	return 0;
+}
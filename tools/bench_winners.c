@@ -0,0 +1,104 @@
+#include <stdio.h> // Include Standard Input Output Library for the report
+#include <stdlib.h> // Include Standard Library for atoi and malloc
+#include <string.h> // Include String Library for memcmp
+#include <time.h> // Include Time Library for clock_gettime
+
+#include "../game.h" // board_winner, the reference
+#include "../winners.h" // Batch win check
+
+// Batch win check against board_winner. First every pair of 9-bit masks goes through both
+// and the results must agree, then both classify the same array of positions from random
+// games a number of times and the boards per second are compared.
+// gcc -O2 -o bench_winners tools/bench_winners.c winners.c game.c           (SSE2)
+// gcc -O2 -mavx2 -o bench_winners tools/bench_winners.c winners.c game.c    (AVX2)
+// ./bench_winners [boards] [passes]
+
+static inline long long now_ns(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static inline unsigned int next_random(unsigned long long *state) {
+	*state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+	return *state >> 33;
+}
+
+// A position partway through a random game, which is where bulk analysis spends its time
+static void random_position(unsigned long long *seed, unsigned short *x, unsigned short *o) {
+	GameBoard board = {0, 0};
+	char turn = 'X';
+	int moves = next_random(seed) % (BOARD_CELLS + 1), line, cell;
+	while (moves-- > 0){
+		do {
+			cell = next_random(seed) % BOARD_CELLS;
+		} while (!(board_empty(board) & (1 << cell)));
+		if (game_move(&board, cell, &turn, &line) != NO_WINNER){
+			break;
+		}
+	}
+	*x = board.x;
+	*o = board.o;
+}
+
+static double time_path(void (*path)(const unsigned short *, const unsigned short *, unsigned char *, int),
+	const unsigned short *x, const unsigned short *o, unsigned char *winners, int count, int passes) {
+	long long start = now_ns();
+	int pass;
+	for (pass = 0; pass < passes; pass++){
+		path(x, o, winners, count);
+		__asm__ volatile("" : : "r"(winners) : "memory"); // Keep every pass
+	}
+	return (double)count * passes / (now_ns() - start) * 1e3;
+}
+
+int main(int argc, char **argv) {
+	int count = argc > 1 ? atoi(argv[1]) : 1 << 16;
+	int passes = argc > 2 ? atoi(argv[2]) : 2000;
+	int all = 512 * 512, size = count > all ? count : all, i;
+	unsigned short *x = malloc(size * sizeof(*x)), *o = malloc(size * sizeof(*o));
+	unsigned char *reference = malloc(size), *batched = malloc(size);
+	unsigned long long seed = 1;
+	long long results[4] = {0};
+
+	if (!x || !o || !reference || !batched || count <= 0){
+		fprintf(stderr, "out of memory\n");
+		return 1;
+	}
+
+	// Every combination of masks, legal or not, odd count so the tail is covered too
+	for (i = 0; i < all; i++){
+		x[i] = i & 511;
+		o[i] = i >> 9;
+	}
+	board_winners_scalar(x, o, reference, all - 1);
+	board_winners(x, o, batched, all - 1);
+	if (memcmp(reference, batched, all - 1) != 0){
+		for (i = 0; reference[i] == batched[i]; i++);
+		fprintf(stderr, "x %03x o %03x: board_winner %d, %s %d\n", x[i], o[i], reference[i], winners_isa(), batched[i]);
+		return 1;
+	}
+
+	for (i = 0; i < count; i++){
+		random_position(&seed, &x[i], &o[i]);
+	}
+	board_winners_scalar(x, o, reference, count);
+	for (i = 0; i < count; i++){
+		results[reference[i]]++;
+	}
+
+	printf("%d boards: %lld going on, %lld won by X, %lld won by O, %lld drawn; %d passes\n",
+		count, results[NO_WINNER], results[X_WINS], results[O_WINS], results[DRAW], passes);
+	printf("board_winner loop  %8.1f M boards/s\n", time_path(board_winners_scalar, x, o, reference, count, passes));
+	printf("%-18s %8.1f M boards/s\n", winners_isa(), time_path(board_winners, x, o, batched, count, passes));
+	if (memcmp(reference, batched, count) != 0){
+		fprintf(stderr, "results differ\n");
+		return 1;
+	}
+
+	free(x);
+	free(o);
+	free(reference);
+	free(batched);
+	return 0;
+}
@@ -0,0 +1,75 @@
+#include <stdio.h> // Include Standard Input Output Library for the report
+
+#include "../capture.h" // Snapshot files and the comparator
+
+// Compares two sets of frames saved by the host build with TICTACTOE_CAPTURE, for example
+// a run of a new renderer against golden frames from a build that is known to be right.
+// Each name covers name.ppm and name.txt, then name-00001.ppm, name-00001.txt, ... for as
+// long as both sets have them.
+// gcc -O2 -o compare_frames tools/compare_frames.c capture.c
+// ./compare_frames new golden
+
+static unsigned short pixelsA[CAPTURE_PIXELS], pixelsB[CAPTURE_PIXELS];
+static char charsA[CAPTURE_CHARS], charsB[CAPTURE_CHARS];
+
+// Returns 1 if the frames differ, 0 if they match, -1 if either one is missing
+static int compare(const char *nameA, const char *nameB) {
+	char pathA[FILENAME_MAX], pathB[FILENAME_MAX];
+	CaptureDiff pixelDiff, textDiff;
+
+	snprintf(pathA, sizeof(pathA), "%s.ppm", nameA);
+	snprintf(pathB, sizeof(pathB), "%s.ppm", nameB);
+	if (!capture_read_ppm(pathA, pixelsA) || !capture_read_ppm(pathB, pixelsB)){
+		return -1;
+	}
+	snprintf(pathA, sizeof(pathA), "%s.txt", nameA);
+	snprintf(pathB, sizeof(pathB), "%s.txt", nameB);
+	if (!capture_read_text(pathA, charsA) || !capture_read_text(pathB, charsB)){
+		return -1;
+	}
+
+	capture_compare_pixels((uintptr_t)pixelsA, (uintptr_t)pixelsB, &pixelDiff);
+	capture_compare_text(charsA, charsB, &textDiff);
+	if (pixelDiff.count){
+		printf("%s: %d pixels differ inside (%d,%d)-(%d,%d)\n", nameA, pixelDiff.count,
+			pixelDiff.x0, pixelDiff.y0, pixelDiff.x1, pixelDiff.y1);
+	}
+	if (textDiff.count){
+		printf("%s: %d characters differ inside columns %d-%d, rows %d-%d\n", nameA, textDiff.count,
+			textDiff.x0, textDiff.x1, textDiff.y0, textDiff.y1);
+	}
+	return pixelDiff.count || textDiff.count;
+}
+
+int main(int argc, char **argv) {
+	char nameA[FILENAME_MAX], nameB[FILENAME_MAX];
+	int frame, result, frames = 0, different = 0;
+
+	if (argc != 3){
+		fprintf(stderr, "usage: %s name golden-name\n", argv[0]);
+		return 2;
+	}
+
+	result = compare(argv[1], argv[2]);
+	if (result >= 0){
+		frames++;
+		different += result;
+	}
+	for (frame = 1; ; frame++){
+		snprintf(nameA, sizeof(nameA), "%s-%05d", argv[1], frame);
+		snprintf(nameB, sizeof(nameB), "%s-%05d", argv[2], frame);
+		result = compare(nameA, nameB);
+		if (result < 0){
+			break;
+		}
+		frames++;
+		different += result;
+	}
+
+	if (frames == 0){
+		fprintf(stderr, "no frames to compare for %s and %s\n", argv[1], argv[2]);
+		return 2;
+	}
+	printf("%d of %d frames differ\n", different, frames);
+	return different ? 1 : 0;
+}
@@ -0,0 +1,92 @@
+
+#include <stdio.h> // Include Standard Input Output Library for writing the table
+#include <string.h> // Include String Library for memset
+
+#include "../game.h" // Bitboard game core
+#include "../ai.h" // Table layout shared with the game
+
+// Solves every legal 3x3 position and prints ai_table.c to stdout.
+// gcc -O2 -o gen_ai_table tools/gen_ai_table.c game.c && ./gen_ai_table > ai_table.c
+
+static unsigned short base3Gen[512];
+static unsigned char table[AI_POSITIONS];
+static signed char scores[AI_POSITIONS];
+static int legalPositions = 0;
+
+// Negamax over the full game tree, memoized per position.
+// Scores are from the point of view of the player to move: faster wins and slower losses score higher.
+static int solve(GameBoard board) {
+	int index = base3Gen[board.x] + 2 * base3Gen[board.o];
+	int count = board_count(board);
+	char turn = (count & 1) ? 'O' : 'X';
+	int best, bestMove, move;
+	unsigned short empty;
+
+	if (table[index] != AI_ILLEGAL){
+		return scores[index];
+	}
+	legalPositions++;
+
+	// The player who just moved completed a line
+	if (winLine[turn == 'X' ? board.o : board.x]){
+		scores[index] = -(BOARD_CELLS + 1 - count);
+		table[index] = AI_NO_MOVE | (AI_LOSS << 4);
+		return scores[index];
+	}
+	if (count == BOARD_CELLS){
+		scores[index] = 0;
+		table[index] = AI_NO_MOVE | (AI_DRAW << 4);
+		return 0;
+	}
+
+	best = -100;
+	bestMove = AI_NO_MOVE;
+	for (empty = board_empty(board); empty; empty &= empty - 1){
+		GameBoard next = board;
+		int score;
+		move = __builtin_ctz(empty);
+		board_place(&next, move, turn);
+		score = -solve(next);
+		if (score > best){
+			best = score;
+			bestMove = move;
+		}
+	}
+
+	scores[index] = best;
+	table[index] = bestMove | ((best > 0 ? AI_WIN : best < 0 ? AI_LOSS : AI_DRAW) << 4);
+	return best;
+}
+
+int main(void) {
+	GameBoard empty = {0, 0};
+	int mask, bit, i;
+
+	for (mask = 0; mask < 512; mask++){
+		int weight = 1;
+		base3Gen[mask] = 0;
+		for (bit = 0; bit < BOARD_CELLS; bit++){
+			if (mask & (1 << bit)){
+				base3Gen[mask] += weight;
+			}
+			weight *= 3;
+		}
+	}
+	memset(table, AI_ILLEGAL, sizeof(table));
+	solve(empty);
+
+	printf("// Generated by tools/gen_ai_table.c, do not edit.\n");
+	printf("// %d legal positions solved, every other entry is AI_ILLEGAL.\n\n", legalPositions);
+	printf("#include \"ai.h\"\n\n");
+	printf("const unsigned short base3[512] = {\n");
+	for (i = 0; i < 512; i++){
+		printf("%s%d,%s", i % 16 ? " " : "\t", base3Gen[i], i % 16 == 15 ? "\n" : "");
+	}
+	printf("};\n\n");
+	printf("const unsigned char aiTable[AI_POSITIONS] = {\n");
+	for (i = 0; i < AI_POSITIONS; i++){
+		printf("%s0x%02X,%s", i % 16 ? " " : "\t", table[i], i % 16 == 15 || i == AI_POSITIONS - 1 ? "\n" : "");
+	}
+	printf("};\n");
+	return 0;
+}
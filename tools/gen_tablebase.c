@@ -0,0 +1,407 @@
+#include <pthread.h> // Include POSIX threads to share each layer between cores
+#include <stdatomic.h> // Include C11 atomics for the bitmaps and the work counter
+#include <stdio.h> // Include Standard Input Output Library for the file and the report
+#include <stdlib.h> // Include Standard Library for atoi and calloc
+#include <time.h> // Include Time Library for clock_gettime
+
+#include "../mnk.h" // m,n,k variant engine
+#include "../solver.h" // Independent check of the values
+#include "../tablebase.h" // Position numbering and the file layout
+
+// Builds the endgame tablebase of an m x n board with k in a row by retrograde analysis.
+// Every move adds a stone, so positions fall into layers by stone count and a position
+// only leads into the next layer. A forward pass over the layers marks the positions that
+// can come up in a game, then a backward pass from the full board down to the empty one
+// gives each of them its value and distance to the end from the layer after it. Each
+// layer is split between the threads in chunks of occupied-square sets.
+//
+// Every position is solved, symmetric copies included, and only the smallest copy is
+// written. After writing, the file is mapped and every position is looked up through its
+// canonical copy and compared with what was solved, and a sample of positions is solved
+// again from scratch with solver_run.
+// gcc -O2 -pthread -o gen_tablebase tools/gen_tablebase.c tablebase.c solver.c mnk.c
+// ./gen_tablebase rows cols k [threads] [file] [distances 0/1] [positions checked with the solver]
+
+#define CHUNK_SETS 256 // Occupied-square sets a thread takes at a time
+#define MAX_THREADS 64
+
+typedef enum { PASS_EXPAND, PASS_SOLVE, PASS_CHECK } Pass;
+
+static struct {
+	TablebaseGeometry geometry;
+	const Tablebase *file; // The written file, for PASS_CHECK
+	int threads;
+	Pass pass;
+	int layer;
+	atomic_ullong nextChunk;
+	_Atomic uint64_t *reachable; // One bit per position number
+	_Atomic uint64_t *kept; // Reachable and the smallest of its symmetric copies
+	uint8_t *entries; // Per position number: value, distance << 2
+	atomic_ullong reachableCount[TABLEBASE_MAX_CELLS + 1];
+	atomic_ullong keptCount[TABLEBASE_MAX_CELLS + 1];
+	atomic_ullong mismatches;
+} generator;
+
+static double now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static inline bool test_bit(_Atomic uint64_t *bits, uint64_t i) {
+	return (atomic_load_explicit(&bits[i >> 6], memory_order_relaxed) >> (i & 63)) & 1;
+}
+
+static inline void set_bit(_Atomic uint64_t *bits, uint64_t i) {
+	atomic_fetch_or_explicit(&bits[i >> 6], (uint64_t)1 << (i & 63), memory_order_relaxed);
+}
+
+// Next set with the same number of squares in colex order (Gosper's hack)
+static inline uint32_t next_set(uint32_t v) {
+	uint32_t t = v | (v - 1);
+	return (t + 1) | (((~t & -~t) - 1) >> (__builtin_ctz(v) + 1));
+}
+
+// The set of count squares with the given colex rank
+static uint32_t unrank_set(const TablebaseGeometry *geometry, int count, uint64_t rank) {
+	uint32_t set = 0;
+	int cell = geometry->cells - 1;
+	for (; count > 0; count--){
+		while (geometry->binomial[cell][count] > rank){
+			cell--;
+		}
+		set |= (uint32_t)1 << cell;
+		rank -= geometry->binomial[cell][count];
+		cell--;
+	}
+	return set;
+}
+
+// Spreads the low bits of pick over the set bits of mask
+static inline uint32_t deposit(uint32_t pick, uint32_t mask) {
+	uint32_t result = 0;
+	for (; mask; mask &= mask - 1, pick >>= 1){
+		if (pick & 1){
+			result |= mask & -mask;
+		}
+	}
+	return result;
+}
+
+// The stones of whoever moved last have a line, or the board is full
+static inline bool game_over(const TablebaseGeometry *geometry, uint32_t x, uint32_t o, int n) {
+	return (n > 0 && tablebase_has_line(geometry, n & 1 ? x : o)) || n == geometry->cells;
+}
+
+// Forward: every move from a reachable position that is not over reaches the next layer
+static void expand(uint32_t x, uint32_t o, int n) {
+	const TablebaseGeometry *geometry = &generator.geometry;
+	uint32_t empty = ~(x | o) & (((uint32_t)1 << geometry->cells) - 1), stone;
+	if (game_over(geometry, x, o, n)){
+		return;
+	}
+	for (; empty; empty &= empty - 1){
+		stone = empty & -empty;
+		set_bit(generator.reachable, n & 1 ? tablebase_number(geometry, x, o | stone) : tablebase_number(geometry, x | stone, o));
+	}
+}
+
+// Backward: the best of the moves, from values already known for the next layer
+static void solve(uint64_t number, uint32_t x, uint32_t o, int n) {
+	const TablebaseGeometry *geometry = &generator.geometry;
+	uint32_t empty = ~(x | o) & (((uint32_t)1 << geometry->cells) - 1), stone, canonicalX = x, canonicalO = o;
+	int value, distance, score, bestScore = -1, best = 0;
+	uint8_t child;
+
+	if (n > 0 && tablebase_has_line(geometry, n & 1 ? x : o)){
+		best = TABLEBASE_LOSS; // The player to move has lost
+	} else if (n == geometry->cells){
+		best = TABLEBASE_DRAW;
+	} else {
+		for (; empty; empty &= empty - 1){
+			stone = empty & -empty;
+			child = generator.entries[n & 1 ? tablebase_number(geometry, x, o | stone) : tablebase_number(geometry, x | stone, o)];
+			value = TABLEBASE_WIN - (child & 3); // The child's value is the opponent's
+			distance = (child >> 2) + 1;
+			// Win as fast as possible, lose as slowly as possible
+			score = value * 256 + (value == TABLEBASE_WIN ? 255 - distance : distance);
+			if (score > bestScore){
+				bestScore = score;
+				best = value | distance << 2;
+			}
+		}
+	}
+	generator.entries[number] = best;
+
+	tablebase_canonical(geometry, &canonicalX, &canonicalO);
+	if (canonicalX == x && canonicalO == o){
+		set_bit(generator.kept, number);
+		atomic_fetch_add_explicit(&generator.keptCount[n], 1, memory_order_relaxed);
+	}
+}
+
+// The file must give every position, canonical or not, what was solved for it
+static void check(uint64_t number, uint32_t x, uint32_t o) {
+	uint8_t entry = generator.entries[number];
+	int distance = tablebase_distance(generator.file, x, o);
+	if (tablebase_value(generator.file, x, o) != (entry & 3) || (generator.file->distances && distance != entry >> 2)){
+		atomic_fetch_add_explicit(&generator.mismatches, 1, memory_order_relaxed);
+	}
+}
+
+// Runs the current pass over the positions of the current layer, a chunk at a time
+static void * pass_main(void *arg) {
+	const TablebaseGeometry *geometry = &generator.geometry;
+	int n = generator.layer, nx = geometry->nx[n];
+	uint64_t sets = geometry->binomial[geometry->cells][n], perSet = geometry->binomial[n][nx];
+	uint64_t chunk, set, end, number, pick, reachable = 0;
+	uint32_t occupied, xPick, x, o;
+	(void)arg;
+
+	while ((chunk = atomic_fetch_add(&generator.nextChunk, 1)) * CHUNK_SETS < sets){
+		set = chunk * CHUNK_SETS;
+		end = set + CHUNK_SETS < sets ? set + CHUNK_SETS : sets;
+		occupied = unrank_set(geometry, n, set);
+		for (; set < end; set++){
+			number = geometry->layerStart[n] + set * perSet;
+			xPick = ((uint32_t)1 << nx) - 1;
+			for (pick = 0; pick < perSet; pick++, number++){
+				if (test_bit(generator.reachable, number)){
+					x = deposit(xPick, occupied);
+					o = occupied & ~x;
+					reachable++;
+					if (generator.pass == PASS_EXPAND){
+						expand(x, o, n);
+					} else if (generator.pass == PASS_SOLVE){
+						solve(number, x, o, n);
+					} else {
+						check(number, x, o);
+					}
+				}
+				if (pick + 1 < perSet){
+					xPick = next_set(xPick);
+				}
+			}
+			if (set + 1 < end){
+				occupied = next_set(occupied);
+			}
+		}
+	}
+	if (generator.pass == PASS_EXPAND){
+		atomic_fetch_add(&generator.reachableCount[n], reachable);
+	}
+	return 0;
+}
+
+static void run_pass(Pass pass, int layer) {
+	pthread_t threads[MAX_THREADS];
+	int i;
+	generator.pass = pass;
+	generator.layer = layer;
+	atomic_store(&generator.nextChunk, 0);
+	for (i = 0; i < generator.threads; i++){
+		pthread_create(&threads[i], 0, pass_main, 0);
+	}
+	for (i = 0; i < generator.threads; i++){
+		pthread_join(threads[i], 0);
+	}
+}
+
+static uint64_t align_section(uint64_t offset) {
+	return (offset + 63) & ~(uint64_t)63;
+}
+
+static bool write_padding(FILE *file, uint64_t from, uint64_t to) {
+	for (; from < to; from++){
+		if (fputc(0, file) == EOF){
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool write_tablebase(const char *path, bool distances, uint64_t *size) {
+	const TablebaseGeometry *geometry = &generator.geometry;
+	uint64_t positions = geometry->layerStart[geometry->cells + 1], words = (positions + 63) / 64;
+	uint64_t rankCount = positions / TABLEBASE_RANK_BITS + 1, kept = 0, w, bits, i;
+	TablebaseHeader header = {{'T', 'T', 'T', 'B'}, TABLEBASE_VERSION, geometry->rows, geometry->cols, geometry->k,
+		distances, {0}, positions, 0, 0, 0, 0, 0, 0};
+	uint32_t *ranks = calloc(rankCount, sizeof(*ranks));
+	uint8_t *values, *distance;
+	uint64_t word;
+	bool ok;
+	FILE *file;
+
+	for (w = 0; w < words; w++){
+		if (w % (TABLEBASE_RANK_BITS / 64) == 0){
+			ranks[w / (TABLEBASE_RANK_BITS / 64)] = kept;
+		}
+		kept += __builtin_popcountll(atomic_load(&generator.kept[w]));
+	}
+	for (w = words / (TABLEBASE_RANK_BITS / 64) + 1; w < rankCount; w++){
+		ranks[w] = kept; // Block past the last word, read by nothing but sized for the reader's check
+	}
+	values = calloc((kept + 3) / 4 + 1, 1);
+	distance = calloc(kept + 1, 1);
+	if (!ranks || !values || !distance){
+		free(ranks);
+		free(values);
+		free(distance);
+		return false;
+	}
+
+	// Values and distances of the kept positions, in position order
+	for (w = 0, i = 0; w < words; w++){
+		for (bits = atomic_load(&generator.kept[w]); bits; bits &= bits - 1, i++){
+			uint8_t entry = generator.entries[w * 64 + __builtin_ctzll(bits)];
+			values[i >> 2] |= (entry & 3) << ((i & 3) * 2);
+			distance[i] = entry >> 2;
+		}
+	}
+
+	header.kept = kept;
+	header.bitmapOffset = align_section(sizeof(header));
+	header.ranksOffset = align_section(header.bitmapOffset + words * 8);
+	header.valuesOffset = align_section(header.ranksOffset + rankCount * 4);
+	header.distancesOffset = distances ? align_section(header.valuesOffset + (kept + 3) / 4) : 0;
+	header.size = distances ? header.distancesOffset + kept : header.valuesOffset + (kept + 3) / 4;
+
+	file = fopen(path, "wb");
+	ok = file && fwrite(&header, sizeof(header), 1, file) == 1 && write_padding(file, sizeof(header), header.bitmapOffset);
+	for (w = 0; w < words && ok; w++){
+		word = atomic_load(&generator.kept[w]);
+		ok = fwrite(&word, sizeof(word), 1, file) == 1;
+	}
+	ok = ok && write_padding(file, header.bitmapOffset + words * 8, header.ranksOffset)
+		&& fwrite(ranks, 4, rankCount, file) == rankCount
+		&& write_padding(file, header.ranksOffset + rankCount * 4, header.valuesOffset)
+		&& fwrite(values, 1, (kept + 3) / 4, file) == (kept + 3) / 4;
+	if (distances){
+		ok = ok && write_padding(file, header.valuesOffset + (kept + 3) / 4, header.distancesOffset)
+			&& fwrite(distance, 1, kept, file) == kept;
+	}
+	if (file && fclose(file) != 0){
+		ok = false;
+	}
+	*size = header.size;
+	free(ranks);
+	free(values);
+	free(distance);
+	return ok;
+}
+
+// Positions from random games that are not over yet, solved again with the search
+static int check_with_solver(const Tablebase *tablebase, int count, int threads) {
+	const TablebaseGeometry *geometry = &generator.geometry;
+	unsigned long long seed = 0x9E3779B97F4A7C15ULL;
+	int checked = 0, wrong = 0, attempts, stones, move, result;
+	uint32_t x, o;
+	SolverResult solved;
+	MnkBoard board;
+
+	for (attempts = 0; checked < count && attempts < count * 100; attempts++){
+		mnk_init(&board, geometry->rows, geometry->cols, geometry->k);
+		stones = geometry->cells / 3 + (int)(seed >> 60) % (geometry->cells - geometry->cells / 3);
+		result = 0;
+		while (board.count < stones && result == 0){
+			do {
+				seed ^= seed << 13;
+				seed ^= seed >> 7;
+				seed ^= seed << 17;
+				move = mnk_move(&board, (seed >> 8) % geometry->rows, (seed >> 24) % geometry->cols);
+			} while (!mnk_is_empty(&board, move));
+			result = mnk_play(&board, move);
+		}
+		if (result != 0){
+			continue;
+		}
+		if (!solver_run(&board, threads, 2, 20, &solved)){
+			break;
+		}
+		tablebase_from_mnk(&board, &x, &o);
+		if (tablebase_value(tablebase, x, o) != solved.value + 1){
+			wrong++;
+		}
+		checked++;
+	}
+	printf("%d positions checked with the solver, %d wrong\n", checked, wrong);
+	return wrong;
+}
+
+int main(int argc, char **argv) {
+	const TablebaseGeometry *geometry = &generator.geometry;
+	const char *path = argc > 5 ? argv[5] : "tablebase.bin";
+	bool distances = argc > 6 ? atoi(argv[6]) != 0 : true;
+	int checks = argc > 7 ? atoi(argv[7]) : 200;
+	uint64_t positions, reachable = 0, kept = 0, size;
+	Tablebase tablebase;
+	double start, forward, backward;
+	int n, rootValue;
+
+	if (argc < 4){
+		fprintf(stderr, "usage: %s rows cols k [threads] [file] [distances 0/1] [positions checked with the solver]\n", argv[0]);
+		return 2;
+	}
+	generator.threads = argc > 4 ? atoi(argv[4]) : 1;
+	if (!tablebase_geometry_init(&generator.geometry, atoi(argv[1]), atoi(argv[2]), atoi(argv[3]))
+		|| generator.threads < 1 || generator.threads > MAX_THREADS){
+		fprintf(stderr, "unsupported board or thread count (at most %d squares, %d threads)\n", TABLEBASE_MAX_CELLS, MAX_THREADS);
+		return 2;
+	}
+	positions = geometry->layerStart[geometry->cells + 1];
+	generator.reachable = calloc((positions + 63) / 64, sizeof(uint64_t));
+	generator.kept = calloc((positions + 63) / 64, sizeof(uint64_t));
+	generator.entries = malloc(positions);
+	if (!generator.reachable || !generator.kept || !generator.entries){
+		fprintf(stderr, "cannot allocate %.1f MB for %llu positions\n", positions * 1.25 / 1e6, (unsigned long long)positions);
+		return 1;
+	}
+
+	start = now();
+	set_bit(generator.reachable, 0); // The empty board
+	for (n = 0; n < geometry->cells; n++){
+		run_pass(PASS_EXPAND, n);
+	}
+	run_pass(PASS_EXPAND, geometry->cells); // Only counts, a full board leads nowhere
+	forward = now() - start;
+	for (n = geometry->cells; n >= 0; n--){
+		run_pass(PASS_SOLVE, n);
+	}
+	backward = now() - start - forward;
+
+	printf("%dx%d k=%d, %d threads\n\nstones    positions    reachable         kept\n", geometry->rows, geometry->cols, geometry->k, generator.threads);
+	for (n = 0; n <= geometry->cells; n++){
+		printf("%6d %12llu %12llu %12llu\n", n, (unsigned long long)(geometry->layerStart[n + 1] - geometry->layerStart[n]),
+			(unsigned long long)generator.reachableCount[n], (unsigned long long)generator.keptCount[n]);
+		reachable += generator.reachableCount[n];
+		kept += generator.keptCount[n];
+	}
+	rootValue = generator.entries[0] & 3;
+	printf(" total %12llu %12llu %12llu\n\n", (unsigned long long)positions, (unsigned long long)reachable, (unsigned long long)kept);
+	printf("empty board: %s in %d plies\n", rootValue == TABLEBASE_WIN ? "first player wins"
+		: rootValue == TABLEBASE_LOSS ? "second player wins" : "draw", generator.entries[0] >> 2);
+	printf("forward pass %.2f s, backward pass %.2f s\n", forward, backward);
+
+	if (!write_tablebase(path, distances, &size)){
+		fprintf(stderr, "cannot write %s\n", path);
+		return 1;
+	}
+	printf("%s: %llu bytes, %.2f bits per kept position\n", path, (unsigned long long)size, size * 8.0 / kept);
+
+	if (!tablebase_open(&tablebase, path)){
+		fprintf(stderr, "cannot map %s\n", path);
+		return 1;
+	}
+	generator.file = &tablebase;
+	start = now();
+	for (n = 0; n <= geometry->cells; n++){
+		run_pass(PASS_CHECK, n);
+	}
+	printf("%llu reachable positions looked up in %.2f s, %llu wrong\n", (unsigned long long)reachable, now() - start,
+		(unsigned long long)generator.mismatches);
+	if (check_with_solver(&tablebase, checks, generator.threads) || generator.mismatches){
+		return 1;
+	}
+	tablebase_close(&tablebase);
+	return 0;
+}
@@ -0,0 +1,238 @@
+#include <errno.h> // Include Error Numbers for EAGAIN
+#include <fcntl.h> // Include File Control for non-blocking sockets
+#include <stdio.h> // Include Standard Input Output Library for the report
+#include <stdlib.h> // Include Standard Library for atoi and calloc
+#include <string.h> // Include String Library for strerror
+#include <time.h> // Include Time Library for clock_gettime
+#include <unistd.h> // Include POSIX Library for read, write and close
+#include <sys/epoll.h> // Include epoll to wait on every connection at once
+#include <sys/resource.h> // Include Resource Limits to allow one descriptor per connection
+#include <sys/socket.h> // Include Sockets Library for connect
+#include <sys/un.h> // Include Unix Domain Sockets for sockaddr_un
+
+#include "../session.h" // Board masks and results in the replies
+#include "../protocol.h" // Requests and replies on the wire
+
+// Load generator for server.c. Opens many connections and keeps a fixed number of
+// requests in flight on each: mostly moves into empty boxes, a new game once a game is
+// over, and now and then a state or scoreboard query. Half the connections play against
+// the computer. Latency is the time from writing a request to reading its reply, kept
+// in a histogram of whole microseconds.
+// gcc -O2 -o load_server tools/load_server.c
+// ./tictactoe_server & ./load_server [connections] [seconds] [requests in flight per connection] [socket path]
+
+#define MAX_IN_FLIGHT 16 // The server queues up to 32 requests per connection
+#define LATENCY_BUCKETS (1 << 20) // 1 us each, anything slower than a second lands in the last one
+#define LOAD_EVENTS 1024
+
+typedef struct {
+	int fd;
+	uint32_t nextTag; // Tag of the next request, the oldest one in flight is nextTag - inFlight
+	int inFlight;
+	int received; // Bytes of a reply that came in pieces
+	bool gameOver;
+	uint16_t taken; // Boxes taken on the board in the last reply
+	unsigned long long seed;
+	long long sentNs[MAX_IN_FLIGHT]; // Send time by tag % MAX_IN_FLIGHT
+	unsigned char buffer[MAX_IN_FLIGHT * sizeof(ProtocolReply)];
+} Client;
+
+static unsigned int latency[LATENCY_BUCKETS];
+static unsigned long long replies, illegal, finished, mismatched;
+
+static inline long long now_ns(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static inline unsigned int next_random(unsigned long long *state) {
+	*state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+	return *state >> 33;
+}
+
+static void next_request(Client *client, ProtocolRequest *request) {
+	unsigned int roll = next_random(&client->seed) % 100;
+	unsigned int empty = ~client->taken & BOARD_FULL;
+	int skip;
+
+	request->cell = 0;
+	request->reserved = 0;
+	request->tag = client->nextTag;
+	if (client->gameOver || empty == 0){
+		request->type = PROTOCOL_NEW_GAME;
+		client->gameOver = false;
+		client->taken = 0;
+	} else if (roll < 10){
+		request->type = PROTOCOL_STATE;
+	} else if (roll < 20){
+		request->type = PROTOCOL_SCOREBOARD;
+	} else {
+		// Random empty box, as far as the last reply knew; replies still in flight may make it illegal
+		request->type = PROTOCOL_MOVE;
+		for (skip = next_random(&client->seed) % __builtin_popcount(empty); skip > 0; skip--){
+			empty &= empty - 1;
+		}
+		request->cell = __builtin_ctz(empty);
+		client->taken |= 1 << request->cell;
+	}
+}
+
+// Writes count requests in one call
+static bool send_requests(Client *client, int count) {
+	ProtocolRequest requests[MAX_IN_FLIGHT];
+	long long now = now_ns();
+	int i;
+
+	for (i = 0; i < count; i++){
+		next_request(client, &requests[i]);
+		client->sentNs[client->nextTag % MAX_IN_FLIGHT] = now;
+		client->nextTag++;
+	}
+	client->inFlight += count;
+	// A few requests always fit in an empty socket buffer, so a short write means the server is gone
+	return write(client->fd, requests, count * sizeof(ProtocolRequest)) == (ssize_t)(count * sizeof(ProtocolRequest));
+}
+
+// Reads the replies that arrived and sends one new request for each
+static bool receive_replies(Client *client, bool measure) {
+	ProtocolReply reply;
+	ssize_t length = read(client->fd, client->buffer + client->received, sizeof(client->buffer) - client->received);
+	long long now = now_ns(), elapsed;
+	int count, i;
+
+	if (length <= 0){
+		return length < 0 && errno == EAGAIN;
+	}
+	client->received += length;
+	count = client->received / sizeof(ProtocolReply);
+
+	for (i = 0; i < count; i++){
+		memcpy(&reply, client->buffer + i * sizeof(ProtocolReply), sizeof(reply));
+		if (reply.tag != client->nextTag - client->inFlight){
+			mismatched++;
+		}
+		if (measure){
+			elapsed = (now - client->sentNs[reply.tag % MAX_IN_FLIGHT]) / 1000;
+			latency[elapsed < LATENCY_BUCKETS ? elapsed : LATENCY_BUCKETS - 1]++;
+			replies++;
+		}
+		client->inFlight--;
+		client->taken = reply.x | reply.o;
+		if (reply.type == PROTOCOL_MOVE && reply.result == SESSION_ILLEGAL){
+			illegal++;
+		}
+		if (reply.result > NO_WINNER){
+			client->gameOver = true;
+			if (reply.type == PROTOCOL_MOVE){
+				finished++;
+			}
+		}
+	}
+	client->received -= count * sizeof(ProtocolReply);
+	memmove(client->buffer, client->buffer + count * sizeof(ProtocolReply), client->received);
+	return count == 0 || send_requests(client, count);
+}
+
+static unsigned int percentile(unsigned long long total, double fraction) {
+	unsigned long long target = total * fraction, seen = 0;
+	unsigned int i;
+	for (i = 0; i < LATENCY_BUCKETS; i++){
+		seen += latency[i];
+		if (seen > target){
+			return i;
+		}
+	}
+	return LATENCY_BUCKETS - 1;
+}
+
+int main(int argc, char **argv) {
+	int count = argc > 1 ? atoi(argv[1]) : 10000;
+	double seconds = argc > 2 ? atof(argv[2]) : 10;
+	int depth = argc > 3 ? atoi(argv[3]) : 1;
+	const char *path = argc > 4 ? argv[4] : PROTOCOL_SOCKET;
+	struct epoll_event event, *events = calloc(LOAD_EVENTS, sizeof(*events));
+	Client *clients = calloc(count > 0 ? count : 1, sizeof(*clients));
+	struct sockaddr_un address;
+	struct rlimit limit;
+	long long start, measureStart, end, now;
+	unsigned int worst;
+	int epollFd, ready, i;
+	bool measure = false;
+
+	if (!clients || !events || count <= 0 || depth < 1 || depth > MAX_IN_FLIGHT){
+		fprintf(stderr, "usage: %s [connections] [seconds] [requests in flight, 1-%d] [socket path]\n", argv[0], MAX_IN_FLIGHT);
+		return 2;
+	}
+	if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < (rlim_t)count + 16){
+		limit.rlim_cur = (rlim_t)count + 16 < limit.rlim_max ? (rlim_t)count + 16 : limit.rlim_max;
+		setrlimit(RLIMIT_NOFILE, &limit);
+	}
+
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	snprintf(address.sun_path, sizeof(address.sun_path), "%s", path);
+	epollFd = epoll_create1(0);
+
+	// Blocking connects, so a full listen backlog waits for the server instead of failing
+	start = now_ns();
+	for (i = 0; i < count; i++){
+		clients[i].fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (clients[i].fd < 0 || connect(clients[i].fd, (struct sockaddr *)&address, sizeof(address)) < 0){
+			fprintf(stderr, "connection %d: %s\n", i, strerror(errno));
+			return 1;
+		}
+		fcntl(clients[i].fd, F_SETFL, O_NONBLOCK);
+		clients[i].seed = i + 1;
+		event.events = EPOLLIN;
+		event.data.u32 = i;
+		epoll_ctl(epollFd, EPOLL_CTL_ADD, clients[i].fd, &event);
+	}
+	printf("%d connections in %.2f s\n", count, (now_ns() - start) / 1e9);
+
+	// Half the connections play against the computer; that request starts each connection off
+	for (i = 0; i < count; i++){
+		ProtocolRequest request = { PROTOCOL_COMPUTER, i & 1, 0, 0 };
+		clients[i].sentNs[0] = now_ns();
+		clients[i].nextTag = 1;
+		clients[i].inFlight = 1;
+		if (write(clients[i].fd, &request, sizeof(request)) != sizeof(request) || !send_requests(&clients[i], depth - 1)){
+			fprintf(stderr, "connection %d: write failed\n", i);
+			return 1;
+		}
+	}
+
+	// A tenth of the run warms up before the measurement starts
+	start = now_ns();
+	measureStart = start + (long long)(seconds * 1e8);
+	end = start + (long long)(seconds * 1.1e9);
+	for (now = start; now < end; now = now_ns()){
+		if (!measure && now >= measureStart){
+			measure = true;
+			measureStart = now;
+		}
+		ready = epoll_wait(epollFd, events, LOAD_EVENTS, 100);
+		for (i = 0; i < ready; i++){
+			if (!receive_replies(&clients[events[i].data.u32], measure)){
+				fprintf(stderr, "connection %u: server hung up\n", events[i].data.u32);
+				return 1;
+			}
+		}
+	}
+	now = now_ns();
+
+	for (worst = LATENCY_BUCKETS - 1; worst > 0 && latency[worst] == 0; worst--);
+	printf("%llu requests in %.2f s, %d in flight per connection\n", replies, (now - measureStart) / 1e9, depth);
+	printf("%.0f requests/s\n", replies / ((now - measureStart) / 1e9));
+	printf("latency p50 %u us, p99 %u us, worst %u%s us\n", percentile(replies, 0.50), percentile(replies, 0.99),
+		worst, worst == LATENCY_BUCKETS - 1 ? "+" : "");
+	printf("%llu games finished, %llu illegal moves, %llu replies out of order\n", finished, illegal, mismatched);
+
+	for (i = 0; i < count; i++){
+		close(clients[i].fd);
+	}
+	close(epollFd);
+	free(clients);
+	free(events);
+	return mismatched ? 1 : 0;
+}
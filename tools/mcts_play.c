@@ -0,0 +1,60 @@
+
+#include <stdio.h> // Include Standard Input Output Library for the report
+#include <stdlib.h> // Include Standard Library for atoi
+#include <string.h> // Include String Library for strlen
+
+#include "../mnk.h" // m,n,k variant engine
+#include "../mcts.h" // Monte Carlo Tree Search player
+
+// Asks the MCTS player for a move and reports playouts/sec.
+// gcc -O2 -pthread -o mcts_play tools/mcts_play.c mcts.c mnk.c -lm
+// ./mcts_play rows cols k [threads] [playouts] [milliseconds] [position]
+// position lists the squares row by row with '.', 'X' and 'O', e.g. "XX.OO...." on 3x3.
+
+int main(int argc, char **argv) {
+	MnkBoard board;
+	MctsOptions options = mctsDefaults;
+	MctsStats stats;
+	int rows, cols, k, move, i;
+
+	if (argc < 4){
+		fprintf(stderr, "usage: %s rows cols k [threads] [playouts] [milliseconds] [position]\n", argv[0]);
+		return 2;
+	}
+	rows = atoi(argv[1]);
+	cols = atoi(argv[2]);
+	k = atoi(argv[3]);
+	if (argc > 4) options.threads = atoi(argv[4]);
+	if (argc > 5) options.playouts = atoll(argv[5]);
+	if (argc > 6) options.milliseconds = atoi(argv[6]);
+	if (!mnk_init(&board, rows, cols, k)){
+		fprintf(stderr, "unsupported board %dx%d k=%d\n", rows, cols, k);
+		return 2;
+	}
+
+	// Stones go on in the order X, O, X ... so the counts decide who is to move
+	if (argc > 7){
+		const char *position = argv[7];
+		if ((int)strlen(position) != rows * cols){
+			fprintf(stderr, "position needs %d squares\n", rows * cols);
+			return 2;
+		}
+		for (i = 0; i < rows * cols; i++){
+			if (position[i] == 'X' || position[i] == 'O'){
+				mnk_set(&board.stones[position[i] == 'O'], mnk_move(&board, i / cols, i % cols));
+				board.count++;
+			}
+		}
+	}
+
+	move = mcts_best_move(&board, &options, &stats);
+	if (move == 0){
+		printf("game is over\n");
+		return 0;
+	}
+	printf("%dx%d k=%d: play box %d (row %d, col %d), expected score %.3f\n", rows, cols, k,
+		move, (move - 1) / cols, (move - 1) % cols, stats.winRate);
+	printf("%lld playouts in %.3f s on %d threads, %.0f playouts/s, %d tree nodes\n",
+		stats.playouts, stats.seconds, options.threads, stats.playouts / stats.seconds, stats.nodes);
+	return 0;
+}
@@ -0,0 +1,68 @@
+
+#include <stdio.h> // Include Standard Input Output Library for the report
+#include <stdlib.h> // Include Standard Library for atoi
+#include <time.h> // Include Time Library for clock_gettime
+
+#include "../mnk.h" // m,n,k variant engine
+#include "../solver.h" // Parallel solver
+
+// Solves an empty m x n board with k in a row and prints per-thread statistics.
+// gcc -O2 -pthread -o psolve tools/psolve.c solver.c mnk.c
+// ./psolve rows cols k [threads] [split depth] [table bits]
+
+static double now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv) {
+	MnkBoard board;
+	SolverResult result;
+	SolverThreadStats total = {0, 0, 0, 0, 0, 0};
+	int rows, cols, k, threads = 1, splitDepth = 3, ttBits = 24, i;
+	double start, elapsed;
+
+	if (argc < 4){
+		fprintf(stderr, "usage: %s rows cols k [threads] [split depth] [table bits]\n", argv[0]);
+		return 2;
+	}
+	rows = atoi(argv[1]);
+	cols = atoi(argv[2]);
+	k = atoi(argv[3]);
+	if (argc > 4) threads = atoi(argv[4]);
+	if (argc > 5) splitDepth = atoi(argv[5]);
+	if (argc > 6) ttBits = atoi(argv[6]);
+
+	if (!mnk_init(&board, rows, cols, k)){
+		fprintf(stderr, "unsupported board %dx%d k=%d\n", rows, cols, k);
+		return 2;
+	}
+	start = now();
+	if (!solver_run(&board, threads, splitDepth, ttBits, &result)){
+		fprintf(stderr, "solver settings out of range\n");
+		return 2;
+	}
+	elapsed = now() - start;
+
+	printf("%dx%d k=%d: %s, best first move %d (row %d, col %d)\n", rows, cols, k,
+		result.value > 0 ? "first player wins" : result.value < 0 ? "second player wins" : "draw",
+		result.bestMove, result.bestMove / cols, result.bestMove % cols);
+	printf("%d threads, split depth %d, %llu split tasks, %.3f s\n\n", threads, splitDepth, result.splitTasks, elapsed);
+	printf("thread        nodes      tasks     steals   attempts   tt hit\n");
+	for (i = 0; i < threads; i++){
+		SolverThreadStats *s = &result.thread[i];
+		printf("%6d %12llu %10llu %10llu %10llu %7.1f%%\n", i, s->nodes, s->tasks, s->steals, s->stealAttempts,
+			s->ttProbes ? 100.0 * s->ttHits / s->ttProbes : 0.0);
+		total.nodes += s->nodes;
+		total.tasks += s->tasks;
+		total.steals += s->steals;
+		total.stealAttempts += s->stealAttempts;
+		total.ttProbes += s->ttProbes;
+		total.ttHits += s->ttHits;
+	}
+	printf(" total %12llu %10llu %10llu %10llu %7.1f%%\n", total.nodes, total.tasks, total.steals, total.stealAttempts,
+		total.ttProbes ? 100.0 * total.ttHits / total.ttProbes : 0.0);
+	printf("\n%.2f Mnodes/s\n", total.nodes / elapsed / 1e6);
+	return 0;
+}
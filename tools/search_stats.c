@@ -0,0 +1,96 @@
+
+#include <stdio.h> // Include Standard Input Output Library for the report
+#include <time.h> // Include Time Library for clock_gettime
+
+#include "../game.h" // Bitboard game core
+#include "../ai.h" // Solved table, used to check the search results
+#include "../search.h" // Negamax engine
+
+// Searches every legal position with the engine features switched on one at a time
+// and reports nodes/sec and transposition table hit rates.
+// gcc -O2 -o search_stats tools/search_stats.c search.c game.c ai_table.c && ./search_stats
+
+static GameBoard positions[AI_POSITIONS];
+static char turns[AI_POSITIONS];
+static int positionCount = 0;
+static unsigned char seen[AI_POSITIONS];
+
+// Collects every position reachable in a legal game, games that are over included
+static void collect(GameBoard board, char turn) {
+	unsigned short empty;
+	int index = ai_index(board);
+	if (seen[index]){
+		return;
+	}
+	seen[index] = 1;
+	positions[positionCount] = board;
+	turns[positionCount] = turn;
+	positionCount++;
+	if (board_winner(board) != NO_WINNER){
+		return;
+	}
+	for (empty = board_empty(board); empty; empty &= empty - 1){
+		GameBoard next = board;
+		board_place(&next, __builtin_ctz(empty), turn);
+		collect(next, turn == 'X' ? 'O' : 'X');
+	}
+}
+
+static double now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void run(const char *name, SearchOptions options) {
+	int i, score, move, wrong = 0;
+	double start, elapsed;
+	SearchStats stats;
+
+	search_set_options(options);
+	start = now();
+	for (i = 0; i < positionCount; i++){
+		move = search_best_move(positions[i], turns[i], &score);
+		// Check the value against the solved table
+		if (move >= 0 && (score > 0 ? AI_WIN : score < 0 ? AI_LOSS : AI_DRAW) != ai_outcome(positions[i])){
+			wrong++;
+		}
+	}
+	elapsed = now() - start;
+	stats = search_stats();
+
+	printf("%-28s %12llu nodes %8.2f ms %8.2f Mnodes/s  tt hit %5.1f%%  cutoffs %10llu  wrong %d\n",
+		name, stats.nodes, elapsed * 1e3, stats.nodes / elapsed / 1e6,
+		stats.ttProbes ? 100.0 * stats.ttHits / stats.ttProbes : 0.0, stats.ttCutoffs, wrong);
+}
+
+int main(void) {
+	GameBoard empty = {0, 0};
+	SearchOptions options = {false, false, false, false};
+	int i, canonical = 0;
+
+	search_init();
+	collect(empty, 'X');
+
+	// Count canonical positions with the symmetry lookup tables
+	for (i = 0; i < AI_POSITIONS; i++){
+		seen[i] = 0;
+	}
+	for (i = 0; i < positionCount; i++){
+		int index = ai_index(search_canonical(positions[i]));
+		canonical += !seen[index];
+		seen[index] = 1;
+	}
+	printf("%d legal positions, %d after symmetry reduction\n\n", positionCount, canonical);
+
+	run("negamax", options);
+	options.alphaBeta = true;
+	run("+ alpha-beta", options);
+	options.ordering = true;
+	run("+ move ordering", options);
+	options.transpositions = true;
+	run("+ transposition table", options);
+	options.symmetry = true;
+	run("+ symmetry", options);
+	return 0;
+}
@@ -0,0 +1,193 @@
+#include <stdio.h> // Include Standard Input Output Library for reading and writing trace files
+#include <stdlib.h> // Include Standard Library for malloc and free
+#include <string.h> // Include String Library for memcmp
+
+#include "device.h" // Clocks and the buffers the summary hashes
+#include "trace.h"
+
+#define HEADER_SIZE 13 // Magic, version, record count, bytes lost
+#define SUMMARY_SIZE 28 // Two hashes and three scores
+#define RECORD_MAX 6 // Five varint bytes for 32 bits plus the scancode
+
+static unsigned char records[TRACE_CAPACITY];
+static size_t recordLength = 0;
+static unsigned int recordCount = 0;
+static unsigned int droppedCount = 0; // Bytes that did not fit, everything after the first is lost too
+static unsigned int lastTicks, lastFrame; // When the byte before was recorded
+
+void trace_start(void) {
+	recordLength = 0;
+	recordCount = 0;
+	droppedCount = 0;
+	lastTicks = device_ticks();
+	lastFrame = device_frame_ticks();
+}
+
+bool trace_record(unsigned char byte) {
+	unsigned int ticks = device_ticks(), frame = device_frame_ticks();
+	unsigned int delta = (ticks - lastTicks) / device_ticks_per_us();
+
+	// device_ticks wraps within a minute on the board, long gaps are measured in frames instead
+	if (frame - lastFrame > FRAME_RATE){
+		delta = (frame - lastFrame) * (1000000 / FRAME_RATE);
+	}
+	if (recordLength + RECORD_MAX > TRACE_CAPACITY){
+		droppedCount++;
+		return false;
+	}
+	while (delta >= 0x80){
+		records[recordLength++] = (delta & 0x7F) | 0x80;
+		delta >>= 7;
+	}
+	records[recordLength++] = delta;
+	records[recordLength++] = byte;
+	recordCount++;
+	lastTicks = ticks;
+	lastFrame = frame;
+	return true;
+}
+
+unsigned int trace_count(void) {
+	return recordCount;
+}
+
+unsigned int trace_dropped(void) {
+	return droppedCount;
+}
+
+static uint64_t fnv1a(uint64_t hash, unsigned char byte) {
+	return (hash ^ byte) * 1099511628211ULL;
+}
+
+void trace_summarize(TraceSummary *summary, int xScore, int OScore, int totalMatchesPlayed) {
+	uintptr_t pixels = device_pixel_buffer();
+	volatile char *characters = device_char_buffer();
+	uint64_t hash;
+	unsigned short pixel;
+	int x, y;
+
+	hash = 14695981039346656037ULL;
+	for (y = 0; y < SCREEN_HEIGHT; y++){
+		for (x = 0; x < SCREEN_WIDTH; x++){
+			pixel = *(volatile unsigned short *)(pixels + (y << 10) + (x << 1));
+			hash = fnv1a(fnv1a(hash, pixel & 0xFF), pixel >> 8);
+		}
+	}
+	summary->pixelHash = hash;
+
+	hash = 14695981039346656037ULL;
+	for (y = 0; y < CHAR_ROWS; y++){
+		for (x = 0; x < CHAR_COLUMNS; x++){
+			hash = fnv1a(hash, characters[(y << 7) + x]);
+		}
+	}
+	summary->charHash = hash;
+
+	summary->xScore = xScore;
+	summary->OScore = OScore;
+	summary->totalMatchesPlayed = totalMatchesPlayed;
+}
+
+static void put_le(unsigned char *out, uint64_t value, int size) {
+	int i;
+	for (i = 0; i < size; i++){
+		out[i] = value >> (i * 8);
+	}
+}
+
+static uint64_t get_le(const unsigned char *in, int size) {
+	uint64_t value = 0;
+	int i;
+	for (i = size - 1; i >= 0; i--){
+		value = (value << 8) | in[i];
+	}
+	return value;
+}
+
+bool trace_save(const char *path, const TraceSummary *summary) {
+	unsigned char header[HEADER_SIZE], footer[SUMMARY_SIZE];
+	FILE *file = fopen(path, "wb");
+	bool ok;
+	if (!file){
+		return false;
+	}
+
+	memcpy(header, "TTTR", 4);
+	header[4] = TRACE_VERSION;
+	put_le(header + 5, recordCount, 4);
+	put_le(header + 9, droppedCount, 4);
+	put_le(footer, summary->pixelHash, 8);
+	put_le(footer + 8, summary->charHash, 8);
+	put_le(footer + 16, (unsigned int)summary->xScore, 4);
+	put_le(footer + 20, (unsigned int)summary->OScore, 4);
+	put_le(footer + 24, (unsigned int)summary->totalMatchesPlayed, 4);
+
+	ok = fwrite(header, 1, HEADER_SIZE, file) == HEADER_SIZE
+		&& fwrite(records, 1, recordLength, file) == recordLength
+		&& fwrite(footer, 1, SUMMARY_SIZE, file) == SUMMARY_SIZE;
+	return fclose(file) == 0 && ok;
+}
+
+bool trace_load(const char *path, TraceReader *reader, TraceSummary *summary) {
+	FILE *file = fopen(path, "rb");
+	unsigned char *data;
+	long size;
+	if (!file){
+		return false;
+	}
+	fseek(file, 0, SEEK_END);
+	size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	if (size < HEADER_SIZE + SUMMARY_SIZE || !(data = malloc(size))){
+		fclose(file);
+		return false;
+	}
+	if (fread(data, 1, size, file) != (size_t)size || memcmp(data, "TTTR", 4) != 0 || data[4] != TRACE_VERSION){
+		free(data);
+		fclose(file);
+		return false;
+	}
+	fclose(file);
+
+	const unsigned char *footer = data + size - SUMMARY_SIZE;
+	summary->pixelHash = get_le(footer, 8);
+	summary->charHash = get_le(footer + 8, 8);
+	summary->xScore = (int)get_le(footer + 16, 4);
+	summary->OScore = (int)get_le(footer + 20, 4);
+	summary->totalMatchesPlayed = (int)get_le(footer + 24, 4);
+
+	reader->data = data;
+	reader->count = get_le(data + 5, 4);
+	reader->dropped = get_le(data + 9, 4);
+	reader->offset = HEADER_SIZE;
+	reader->length = size - SUMMARY_SIZE;
+	reader->index = 0;
+	reader->time = 0;
+	return true;
+}
+
+bool trace_next(TraceReader *reader, unsigned char *byte, unsigned int *time) {
+	unsigned int delta = 0;
+	int shift = 0;
+	if (reader->index == reader->count){
+		return false;
+	}
+	do {
+		if (reader->offset + 1 >= reader->length || shift > 28){
+			return false; // Cut off or corrupt
+		}
+		delta |= (reader->data[reader->offset] & 0x7F) << shift;
+		shift += 7;
+	} while (reader->data[reader->offset++] & 0x80);
+
+	reader->time += delta;
+	*byte = reader->data[reader->offset++];
+	*time = reader->time;
+	reader->index++;
+	return true;
+}
+
+void trace_close(TraceReader *reader) {
+	free(reader->data);
+	reader->data = NULL;
+}
@@ -0,0 +1,47 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdbool.h> // Include Standard Boolean Library for boolean variables
+#include <stddef.h> // Include Standard Definitions for size_t
+#include <stdint.h> // Include fixed width integer types for the hashes
+
+// Recorded keyboard input. keygameBoard_ISR hands every PS/2 byte to trace_record, which
+// appends it to a buffer in memory with the microseconds since the byte before it. The
+// host backend saves that buffer at exit, together with a summary of the final state,
+// and can feed a saved trace back in instead of stdin and check the summary matches.
+// Bytes that come once the buffer is full are only counted, and a trace that lost any is
+// replayed without the check, as its summary is of a longer session than it holds.
+//
+// File layout, all numbers little endian:
+//   "TTTR", version byte, record count (4 bytes), bytes lost once the buffer was full (4 bytes)
+//   records: microseconds since the previous byte as a LEB128 varint, then the byte
+//   summary: pixel hash, character hash (8 bytes each), xScore, OScore, totalMatchesPlayed (4 bytes each)
+
+#define TRACE_VERSION 2
+#define TRACE_CAPACITY 65536 // Bytes of records kept in memory, about 20,000 scancodes at typing speed
+
+typedef struct {
+	uint64_t pixelHash; // FNV-1a of the 320x240 pixels on screen
+	uint64_t charHash; // FNV-1a of the 80x60 characters
+	int xScore, OScore, totalMatchesPlayed;
+} TraceSummary;
+
+typedef struct {
+	unsigned char *data; // Records of a loaded trace
+	size_t length, offset; // Record bytes in data, and how far trace_next got
+	unsigned int count, index; // Records in the trace, and how many were read
+	unsigned int dropped; // Bytes the recording lost, 0 if it is complete
+	unsigned int time; // Microseconds of the record read last
+} TraceReader;
+
+void trace_start(void); // Empties the recording, times count from here
+bool trace_record(unsigned char byte); // Appends a byte, false once the buffer is full. Called from the IRQ handler
+unsigned int trace_count(void); // Bytes recorded so far
+unsigned int trace_dropped(void); // Bytes that came after the buffer was full
+void trace_summarize(TraceSummary *summary, int xScore, int OScore, int totalMatchesPlayed); // Hashes what is on screen now
+bool trace_save(const char *path, const TraceSummary *summary); // Writes the recording and summary to a file
+bool trace_load(const char *path, TraceReader *reader, TraceSummary *summary); // Reads a file written by trace_save
+bool trace_next(TraceReader *reader, unsigned char *byte, unsigned int *time); // Next byte and its time in microseconds
+void trace_close(TraceReader *reader);
+
+#endif
@@ -0,0 +1,120 @@
+#include "winners.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h> // Include NEON intrinsics for the A9
+#define LANES 8
+typedef uint16x8_t Lanes;
+#elif defined(__AVX2__)
+#include <immintrin.h> // Include AVX2 intrinsics for the host
+#define LANES 16
+typedef __m256i Lanes;
+#elif defined(__SSE2__)
+#include <emmintrin.h> // Include SSE2 intrinsics for the host
+#define LANES 8
+typedef __m128i Lanes;
+#else
+// No vector unit: board_winners is board_winners_scalar
+#endif
+
+// winLine lookups are as fast as anything a scalar core can do, and exactly board_winner
+void board_winners_scalar(const unsigned short *x, const unsigned short *o, unsigned char *winners, int count) {
+	GameBoard board;
+	int i;
+	for (i = 0; i < count; i++){
+		board.x = x[i];
+		board.o = o[i];
+		winners[i] = board_winner(board);
+	}
+}
+
+#ifdef LANES
+
+// The same steps on every board in a register. Shift counts must be constants, hence macros.
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define lanes_load(p) vld1q_u16(p)
+#define lanes_set(c) vdupq_n_u16(c)
+#define lanes_and(a, b) vandq_u16(a, b)
+#define lanes_or(a, b) vorrq_u16(a, b)
+#define lanes_andnot(a, b) vbicq_u16(b, a) // ~a & b
+#define lanes_equal(a, b) vceqq_u16(a, b)
+#define lanes_shift(v, n) vshrq_n_u16(v, n)
+
+// Narrows the codes of two registers to bytes and stores them
+static inline void store_codes(unsigned char *winners, Lanes a, Lanes b) {
+	vst1q_u8(winners, vcombine_u8(vmovn_u16(a), vmovn_u16(b)));
+}
+#elif defined(__AVX2__)
+#define lanes_load(p) _mm256_loadu_si256((const __m256i *)(p))
+#define lanes_set(c) _mm256_set1_epi16(c)
+#define lanes_and(a, b) _mm256_and_si256(a, b)
+#define lanes_or(a, b) _mm256_or_si256(a, b)
+#define lanes_andnot(a, b) _mm256_andnot_si256(a, b)
+#define lanes_equal(a, b) _mm256_cmpeq_epi16(a, b)
+#define lanes_shift(v, n) _mm256_srli_epi16(v, n)
+
+static inline void store_codes(unsigned char *winners, Lanes a, Lanes b) {
+	// packus works within 128-bit halves, the permute puts the four quarters back in order
+	__m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8);
+	_mm256_storeu_si256((__m256i *)winners, packed);
+}
+#else
+#define lanes_load(p) _mm_loadu_si128((const __m128i *)(p))
+#define lanes_set(c) _mm_set1_epi16(c)
+#define lanes_and(a, b) _mm_and_si128(a, b)
+#define lanes_or(a, b) _mm_or_si128(a, b)
+#define lanes_andnot(a, b) _mm_andnot_si128(a, b)
+#define lanes_equal(a, b) _mm_cmpeq_epi16(a, b)
+#define lanes_shift(v, n) _mm_srli_epi16(v, n)
+
+static inline void store_codes(unsigned char *winners, Lanes a, Lanes b) {
+	_mm_storeu_si128((__m128i *)winners, _mm_packus_epi16(a, b));
+}
+#endif
+
+// All ones where a mask holds no line. Rows are bits 0-2, 3-5 and 6-8 (see winMasks), so
+// a row is complete where a bit and the two after it are set, a column where a bit and
+// the ones 3 and 6 above it are, and each diagonal is the AND of its three bits.
+static inline Lanes lanes_no_line(Lanes v) {
+	Lanes s2 = lanes_shift(v, 2), s4 = lanes_shift(v, 4), s6 = lanes_shift(v, 6);
+	Lanes rows = lanes_and(lanes_and(v, lanes_shift(v, 1)), lanes_and(s2, lanes_set(0x49)));
+	Lanes columns = lanes_and(lanes_and(v, lanes_shift(v, 3)), lanes_and(s6, lanes_set(0x07)));
+	Lanes diagonals = lanes_and(lanes_or(lanes_and(v, lanes_shift(v, 8)), lanes_and(s2, s6)), lanes_and(s4, lanes_set(1)));
+	return lanes_equal(lanes_or(lanes_or(rows, columns), diagonals), lanes_set(0));
+}
+
+// X_WINS where X has a line, else O_WINS where O has one, else DRAW where the board is full
+static inline Lanes lanes_codes(Lanes x, Lanes o) {
+	Lanes xNone = lanes_no_line(x), oNone = lanes_no_line(o);
+	Lanes full = lanes_equal(lanes_or(x, o), lanes_set(BOARD_FULL));
+	Lanes notX = lanes_or(lanes_andnot(oNone, lanes_set(O_WINS)), lanes_and(oNone, lanes_and(full, lanes_set(DRAW))));
+	return lanes_or(lanes_andnot(xNone, lanes_set(X_WINS)), lanes_and(xNone, notX));
+}
+
+void board_winners(const unsigned short *x, const unsigned short *o, unsigned char *winners, int count) {
+	int i;
+	for (i = 0; i + 2 * LANES <= count; i += 2 * LANES){
+		store_codes(winners + i, lanes_codes(lanes_load(x + i), lanes_load(o + i)),
+			lanes_codes(lanes_load(x + i + LANES), lanes_load(o + i + LANES)));
+	}
+	board_winners_scalar(x + i, o + i, winners + i, count - i);
+}
+
+#else
+
+void board_winners(const unsigned short *x, const unsigned short *o, unsigned char *winners, int count) {
+	board_winners_scalar(x, o, winners, count);
+}
+
+#endif
+
+const char * winners_isa(void) {
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+	return "NEON";
+#elif defined(__AVX2__)
+	return "AVX2";
+#elif defined(__SSE2__)
+	return "SSE2";
+#else
+	return "scalar";
+#endif
+}